@@ -0,0 +1,284 @@
+#ifndef COMPONENT_INDEX_HH_
+#define COMPONENT_INDEX_HH_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "simpleECM/MemoryStats.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief A secondary index over the components of one type, which the ECM
+/// keeps up to date as components are added and removed. This is the part of
+/// an index that doesn't depend on the key type
+class BaseComponentIndex
+{
+  /// \brief Get the type of component that is indexed
+  /// \return The component type
+  public: virtual ComponentTypeId TypeId() const = 0;
+
+  /// \brief Add an entity to the index
+  /// \param[in] _entity The entity
+  /// \param[in] _component The entity's component of the indexed type
+  public: virtual void Insert(const Entity &_entity,
+              const void *_component) = 0;
+
+  /// \brief Remove an entity from the index. Nothing happens if the entity
+  /// isn't in the index
+  /// \param[in] _entity The entity
+  public: virtual void Remove(const Entity &_entity) = 0;
+
+  /// \brief Move an entity to the key of its component, which may have
+  /// changed
+  /// \param[in] _entity The entity, which must be in the index
+  /// \param[in] _component The entity's component of the indexed type
+  /// \return true if the entity's key changed, false otherwise
+  public: virtual bool Update(const Entity &_entity,
+              const void *_component) = 0;
+
+  /// \brief Get the number of entities in the index
+  /// \return The number of entities
+  public: virtual std::size_t Size() const = 0;
+
+  /// \brief Get the memory used by the index
+  /// \return The number of bytes used by the index's heap memory
+  public: virtual std::size_t MemoryBytes() const = 0;
+
+  /// \brief Destructor
+  public: virtual ~BaseComponentIndex() = default;
+};
+
+/// \brief A secondary index from a key, which is computed from a component
+/// (a projection), to the entities whose component has that key. The index
+/// stores a bucket of entities per key in a map of type MapT, which is a
+/// std::unordered_map (see HashIndex) or a std::map (see OrderedIndex)
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+class ComponentIndex : public BaseComponentIndex
+{
+  /// \brief The indexed component type
+  public: using Component = ComponentTypeT;
+
+  /// \brief The key type
+  public: using Key = KeyT;
+
+  /// \brief The function that computes the key of a component
+  public: using Projection = std::function<KeyT(const ComponentTypeT &)>;
+
+  /// \brief Whether the keys are ordered, which allows range queries
+  public: constexpr const static bool kOrdered =
+            std::is_same_v<MapT, std::map<KeyT, std::vector<Entity>>>;
+
+  /// \brief Constructor
+  /// \param[in] _projection The function that computes the key of a
+  /// component
+  public: explicit ComponentIndex(Projection _projection);
+
+  /// \brief Documentation inherited
+  public: ComponentTypeId TypeId() const override;
+
+  /// \brief Documentation inherited
+  public: void Insert(const Entity &_entity, const void *_component) override;
+
+  /// \brief Documentation inherited
+  public: void Remove(const Entity &_entity) override;
+
+  /// \brief Documentation inherited
+  public: bool Update(const Entity &_entity, const void *_component) override;
+
+  /// \brief Documentation inherited
+  public: std::size_t Size() const override;
+
+  /// \brief Documentation inherited
+  public: std::size_t MemoryBytes() const override;
+
+  /// \brief Call a function on every entity with a key
+  /// \param[in] _key The key
+  /// \param[in] _f The function, which is called with an entity and returns
+  /// false to stop
+  /// \return false if _f stopped the iteration, true otherwise
+  public: template<typename FunctionT>
+          bool EachEqual(const KeyT &_key, const FunctionT &_f) const;
+
+  /// \brief Call a function on every entity with a key in a range, in key
+  /// order. Only ordered indexes support this
+  /// \param[in] _min The lowest key
+  /// \param[in] _max The highest key (inclusive)
+  /// \param[in] _f The function, which is called with an entity and returns
+  /// false to stop
+  /// \return false if _f stopped the iteration, true otherwise
+  public: template<typename FunctionT>
+          bool EachInRange(const KeyT &_min, const KeyT &_max,
+              const FunctionT &_f) const;
+
+  /// \brief Where an entity is stored in the index
+  private: struct Location
+  {
+    /// \brief The entity's key
+    KeyT key;
+
+    /// \brief The index of the entity in its key's bucket
+    std::size_t index;
+  };
+
+  /// \brief The function that computes the key of a component
+  private: Projection projection;
+
+  /// \brief The entities of every key that at least one entity has
+  private: MapT buckets;
+
+  /// \brief The location of every entity in the index
+  private: std::unordered_map<Entity, Location> locations;
+};
+
+/// \brief An index that finds the entities with a key in constant time
+template<typename ComponentTypeT, typename KeyT>
+using HashIndex = ComponentIndex<ComponentTypeT, KeyT,
+      std::unordered_map<KeyT, std::vector<Entity>>>;
+
+/// \brief An index that keeps its keys sorted, so it can also find the
+/// entities with a key in a range
+template<typename ComponentTypeT, typename KeyT>
+using OrderedIndex = ComponentIndex<ComponentTypeT, KeyT,
+      std::map<KeyT, std::vector<Entity>>>;
+
+/// \brief A handle to an index that was created by an ECM (see
+/// ECM::CreateIndex). The handle is typed, so queries know the index's
+/// component and key types at compile time
+template<typename IndexT>
+struct IndexHandle
+{
+  /// \brief The position of the index in the ECM's list of indexes
+  std::size_t id;
+};
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+ComponentIndex<ComponentTypeT, KeyT, MapT>::ComponentIndex(
+    Projection _projection)
+  : projection(std::move(_projection))
+{
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+ComponentTypeId ComponentIndex<ComponentTypeT, KeyT, MapT>::TypeId() const
+{
+  return ComponentTypeT::typeId;
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+void ComponentIndex<ComponentTypeT, KeyT, MapT>::Insert(const Entity &_entity,
+    const void *_component)
+{
+  if (this->locations.find(_entity) != this->locations.end())
+    return;
+
+  auto key = this->projection(
+      *static_cast<const ComponentTypeT *>(_component));
+  auto &bucket = this->buckets[key];
+  this->locations.emplace(_entity, Location{std::move(key), bucket.size()});
+  bucket.push_back(_entity);
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+void ComponentIndex<ComponentTypeT, KeyT, MapT>::Remove(const Entity &_entity)
+{
+  auto iter = this->locations.find(_entity);
+  if (iter == this->locations.end())
+    return;
+
+  // the last entity of the bucket takes the removed entity's place
+  auto bucketIter = this->buckets.find(iter->second.key);
+  auto &bucket = bucketIter->second;
+  const auto index = iter->second.index;
+  if (index + 1 != bucket.size())
+  {
+    bucket[index] = bucket.back();
+    this->locations.find(bucket[index])->second.index = index;
+  }
+  bucket.pop_back();
+  if (bucket.empty())
+    this->buckets.erase(bucketIter);
+  this->locations.erase(iter);
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+bool ComponentIndex<ComponentTypeT, KeyT, MapT>::Update(const Entity &_entity,
+    const void *_component)
+{
+  auto iter = this->locations.find(_entity);
+  if (iter == this->locations.end())
+    return false;
+
+  if (this->projection(*static_cast<const ComponentTypeT *>(_component)) ==
+      iter->second.key)
+    return false;
+
+  this->Remove(_entity);
+  this->Insert(_entity, _component);
+  return true;
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+std::size_t ComponentIndex<ComponentTypeT, KeyT, MapT>::Size() const
+{
+  return this->locations.size();
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+std::size_t ComponentIndex<ComponentTypeT, KeyT, MapT>::MemoryBytes() const
+{
+  // a std::map node holds the element and about three pointers
+  std::size_t bytes = UnorderedMemoryBytes(this->locations);
+  if constexpr (kOrdered)
+  {
+    bytes += this->buckets.size() *
+      (3 * sizeof(void *) + sizeof(typename MapT::value_type));
+  }
+  else
+  {
+    bytes += UnorderedMemoryBytes(this->buckets);
+  }
+  for (const auto &[key, bucket] : this->buckets)
+    bytes += VectorMemoryBytes(bucket);
+  return bytes;
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+template<typename FunctionT>
+bool ComponentIndex<ComponentTypeT, KeyT, MapT>::EachEqual(const KeyT &_key,
+    const FunctionT &_f) const
+{
+  auto iter = this->buckets.find(_key);
+  if (iter == this->buckets.end())
+    return true;
+
+  for (const auto &entity : iter->second)
+  {
+    if (!_f(entity))
+      return false;
+  }
+  return true;
+}
+
+template<typename ComponentTypeT, typename KeyT, typename MapT>
+template<typename FunctionT>
+bool ComponentIndex<ComponentTypeT, KeyT, MapT>::EachInRange(
+    const KeyT &_min, const KeyT &_max, const FunctionT &_f) const
+{
+  static_assert(kOrdered, "Range queries need an OrderedIndex");
+  for (auto iter = this->buckets.lower_bound(_min);
+       iter != this->buckets.end() && !(_max < iter->first); ++iter)
+  {
+    for (const auto &entity : iter->second)
+    {
+      if (!_f(entity))
+        return false;
+    }
+  }
+  return true;
+}
+
+#endif
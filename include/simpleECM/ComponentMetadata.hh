@@ -0,0 +1,234 @@
+#ifndef COMPONENT_METADATA_HH_
+#define COMPONENT_METADATA_HH_
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simpleECM/Components.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief Trait that marks a component type as safe to relocate with memcpy
+/// (copying the bytes to a new address and never running the destructor at the
+/// old address). Trivially copyable types are always trivially relocatable, and
+/// other types can opt in by specializing this trait
+template<typename ComponentTypeT>
+struct IsTriviallyRelocatable :
+  std::is_trivially_copyable<ComponentTypeT>
+{
+};
+
+// Components.hh types whose data members can all be moved with memcpy. The
+// vtable pointer of these components doesn't point into the component itself,
+// so moving the bytes is safe even though the components are polymorphic
+// (Name only holds a handle to an interned string)
+template<> struct IsTriviallyRelocatable<Name> : std::true_type {};
+template<> struct IsTriviallyRelocatable<World> : std::true_type {};
+template<> struct IsTriviallyRelocatable<Static> : std::true_type {};
+template<> struct IsTriviallyRelocatable<Position> : std::true_type {};
+template<> struct IsTriviallyRelocatable<WorldPosition> : std::true_type {};
+template<> struct IsTriviallyRelocatable<LinearVelocity> : std::true_type {};
+template<> struct IsTriviallyRelocatable<WorldLinearVelocity> :
+  std::true_type {};
+template<> struct IsTriviallyRelocatable<AngularVelocity> : std::true_type {};
+template<> struct IsTriviallyRelocatable<WorldAngularVelocity> :
+  std::true_type {};
+template<> struct IsTriviallyRelocatable<LinearAcceleration> :
+  std::true_type {};
+template<> struct IsTriviallyRelocatable<WorldLinearAcceleration> :
+  std::true_type {};
+template<> struct IsTriviallyRelocatable<Pose> : std::true_type {};
+template<> struct IsTriviallyRelocatable<WorldPose> : std::true_type {};
+
+/// \brief Trait that marks a component type as a tag: a type without data,
+/// whose only meaning is whether an entity has it. Pools of tags store which
+/// entities have the tag, but no per-entity component (every entity shares a
+/// single instance). Types opt in by specializing this trait
+template<typename ComponentTypeT>
+struct IsTagComponent : std::false_type
+{
+};
+
+// Components.hh types that have no data members
+template<> struct IsTagComponent<World> : std::true_type {};
+
+/// \brief Runtime description of a component type. This allows code that
+/// stores components as raw bytes (component pools, cloning, snapshots,
+/// compaction, etc.) to handle any component type without being templated on
+/// it
+struct ComponentMetadata
+{
+  /// \brief The component's typeId
+  ComponentTypeId typeId;
+
+  /// \brief The component's human readable name
+  const char *name;
+
+  /// \brief sizeof(component)
+  std::size_t size;
+
+  /// \brief alignof(component)
+  std::size_t alignment;
+
+  /// \brief Whether the component can be copied with memcpy
+  bool triviallyCopyable;
+
+  /// \brief Whether the component can be moved to a new address with memcpy
+  /// \sa IsTriviallyRelocatable
+  bool triviallyRelocatable;
+
+  /// \brief Whether the component is a tag, which has no per-entity storage
+  /// \sa IsTagComponent
+  bool tag;
+
+  /// \brief Default construct a component at _dst
+  void (*construct)(void *_dst);
+
+  /// \brief Copy construct a component at _dst from the component at _src
+  void (*copyConstruct)(void *_dst, const void *_src);
+
+  /// \brief Move construct a component at _dst from the component at _src
+  void (*moveConstruct)(void *_dst, void *_src);
+
+  /// \brief Destroy the component at _ptr
+  void (*destruct)(void *_ptr);
+};
+
+/// \brief Get the metadata of a component type
+/// \return The metadata of ComponentTypeT
+template<typename ComponentTypeT>
+const ComponentMetadata &ComponentMetadataOf()
+{
+  static const ComponentMetadata metadata{
+    ComponentTypeT::typeId,
+    ComponentTypeT::typeName,
+    sizeof(ComponentTypeT),
+    alignof(ComponentTypeT),
+    std::is_trivially_copyable_v<ComponentTypeT>,
+    IsTriviallyRelocatable<ComponentTypeT>::value,
+    IsTagComponent<ComponentTypeT>::value,
+    [](void *_dst)
+    {
+      new (_dst) ComponentTypeT();
+    },
+    [](void *_dst, const void *_src)
+    {
+      new (_dst) ComponentTypeT(*static_cast<const ComponentTypeT*>(_src));
+    },
+    [](void *_dst, void *_src)
+    {
+      new (_dst) ComponentTypeT(
+          std::move(*static_cast<ComponentTypeT*>(_src)));
+    },
+    [](void *_ptr)
+    {
+      static_cast<ComponentTypeT*>(_ptr)->~ComponentTypeT();
+    }
+  };
+  return metadata;
+}
+
+/// \brief Get the metadata of all of the component types in Components.hh
+/// \return The metadata table, ordered by typeId
+const std::vector<const ComponentMetadata *> &ComponentMetadataTable()
+{
+  static const std::vector<const ComponentMetadata *> table{
+    &ComponentMetadataOf<Name>(),
+    &ComponentMetadataOf<World>(),
+    &ComponentMetadataOf<Static>(),
+    &ComponentMetadataOf<Position>(),
+    &ComponentMetadataOf<WorldPosition>(),
+    &ComponentMetadataOf<LinearVelocity>(),
+    &ComponentMetadataOf<WorldLinearVelocity>(),
+    &ComponentMetadataOf<AngularVelocity>(),
+    &ComponentMetadataOf<WorldAngularVelocity>(),
+    &ComponentMetadataOf<LinearAcceleration>(),
+    &ComponentMetadataOf<WorldLinearAcceleration>(),
+    &ComponentMetadataOf<Pose>(),
+    &ComponentMetadataOf<WorldPose>()
+  };
+  return table;
+}
+
+/// \brief Find the metadata of a component type in Components.hh
+/// \param[in] _typeId The component type
+/// \return The metadata of _typeId, or nullptr if _typeId isn't a component
+/// type defined in Components.hh
+const ComponentMetadata *FindComponentMetadata(const ComponentTypeId &_typeId)
+{
+  for (const auto metadata : ComponentMetadataTable())
+  {
+    if (metadata->typeId == _typeId)
+      return metadata;
+  }
+  return nullptr;
+}
+
+/// \brief Copy construct a contiguous range of components
+/// \param[in] _metadata The type of the components
+/// \param[in] _dst Uninitialized memory for _count components
+/// \param[in] _src The _count components to copy
+/// \param[in] _count The number of components
+void CopyComponents(const ComponentMetadata &_metadata, void *_dst,
+    const void *_src, const std::size_t _count)
+{
+  if (_metadata.triviallyCopyable)
+  {
+    std::memcpy(_dst, _src, _metadata.size * _count);
+    return;
+  }
+
+  auto dst = static_cast<unsigned char *>(_dst);
+  auto src = static_cast<const unsigned char *>(_src);
+  for (std::size_t i = 0; i < _count; ++i)
+    _metadata.copyConstruct(dst + i * _metadata.size,
+        src + i * _metadata.size);
+}
+
+/// \brief Move a contiguous range of components to new memory. Once this
+/// returns, the components at _src no longer exist (their destructors have
+/// either been called, or didn't need to be called)
+/// \param[in] _metadata The type of the components
+/// \param[in] _dst Uninitialized memory for _count components, which must not
+/// overlap with _src
+/// \param[in] _src The _count components to move
+/// \param[in] _count The number of components
+void RelocateComponents(const ComponentMetadata &_metadata, void *_dst,
+    void *_src, const std::size_t _count)
+{
+  if (_metadata.triviallyRelocatable)
+  {
+    std::memcpy(_dst, _src, _metadata.size * _count);
+    return;
+  }
+
+  auto dst = static_cast<unsigned char *>(_dst);
+  auto src = static_cast<unsigned char *>(_src);
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    _metadata.moveConstruct(dst + i * _metadata.size,
+        src + i * _metadata.size);
+    _metadata.destruct(src + i * _metadata.size);
+  }
+}
+
+/// \brief Destroy a contiguous range of components
+/// \param[in] _metadata The type of the components
+/// \param[in] _ptr The _count components to destroy
+/// \param[in] _count The number of components
+void DestroyComponents(const ComponentMetadata &_metadata, void *_ptr,
+    const std::size_t _count)
+{
+  // trivially copyable types have trivial destructors
+  if (_metadata.triviallyCopyable)
+    return;
+
+  auto ptr = static_cast<unsigned char *>(_ptr);
+  for (std::size_t i = 0; i < _count; ++i)
+    _metadata.destruct(ptr + i * _metadata.size);
+}
+
+#endif
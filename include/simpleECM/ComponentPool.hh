@@ -0,0 +1,1008 @@
+#ifndef COMPONENT_POOL_HH_
+#define COMPONENT_POOL_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "simpleECM/ComponentMetadata.hh"
+#include "simpleECM/HugePages.hh"
+#include "simpleECM/MemoryStats.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief Components of a single type that were taken out of a pool, stored
+/// contiguously along with the entities that own them. Columns are used to
+/// move entities between ECMs in bulk (see ECM::ExtractEntities). Columns of
+/// tags (see IsTagComponent) only hold the entities
+class ComponentColumn
+{
+  /// \brief Constructor
+  /// \param[in] _metadata The type of component stored in the column
+  public: explicit ComponentColumn(const ComponentMetadata &_metadata);
+
+  /// \brief Move constructor. The other column is left empty
+  /// \param[in] _other The column to move
+  public: ComponentColumn(ComponentColumn &&_other) noexcept;
+
+  /// \brief Destructor
+  public: ~ComponentColumn();
+
+  /// \brief Columns own raw memory, so they can't be copied
+  public: ComponentColumn(const ComponentColumn &) = delete;
+
+  /// \brief Columns own raw memory, so they can't be copied
+  public: ComponentColumn &operator=(const ComponentColumn &) = delete;
+
+  /// \brief Get the type of component stored in the column
+  /// \return The component metadata
+  public: const ComponentMetadata &Metadata() const;
+
+  /// \brief Get the number of components in the column
+  /// \return The number of components
+  public: std::size_t Size() const;
+
+  /// \brief Get the entities that own the components, in column order
+  /// \return The entities
+  public: const std::vector<Entity> &Entities() const;
+
+  /// \brief Get the address of a component
+  /// \param[in] _index The index of the component, which must be less than
+  /// Size()
+  /// \return The address of the component, or nullptr if the column holds
+  /// tags
+  public: void *Data(const std::size_t _index) const;
+
+  /// \brief Make room for components without reallocating
+  /// \param[in] _count The number of components to make room for
+  public: void Reserve(const std::size_t _count);
+
+  /// \brief Add a component to the end of the column. The caller must
+  /// construct (or relocate) the component at the returned address, unless
+  /// the column holds tags
+  /// \param[in] _entity The entity that owns the component
+  /// \return Uninitialized memory for the component, or nullptr if the
+  /// column holds tags
+  public: void *Append(const Entity &_entity);
+
+  /// \brief Forget all of the components without destroying them, which must
+  /// be done after they have been relocated somewhere else
+  public: void Release();
+
+  /// \brief The type of component stored in the column
+  private: const ComponentMetadata *metadata;
+
+  /// \brief The entity that owns each component
+  private: std::vector<Entity> entities;
+
+  /// \brief The components
+  private: unsigned char *data{nullptr};
+
+  /// \brief The number of components data has room for
+  private: std::size_t capacity{0};
+};
+
+/// \brief Storage for all of the components of a single type. Components are
+/// stored as raw bytes in fixed size pages, which means that a component's
+/// address does not change while the component is in the pool (pages are never
+/// reallocated), unless the pool is compacted or slots are swapped. Slots that
+/// are freed by removing a component are re-used by components that are added
+/// later.
+///
+/// A pool can be double buffered, which gives every component a current value
+/// and a next value. Each page then holds the current values of its slots in
+/// one half and the next values in the other half, and swapping the buffers
+/// just swaps the roles of the halves. The address of a slot in the first half
+/// (its storage address) never changes when the buffers are swapped, so it's
+/// what views store
+///
+/// Pages can be allocated from a HugePageArena instead of the heap (see
+/// SetHugePages), which packs them into large mappings that are backed by
+/// huge pages. Iterating over many components then needs far fewer TLB
+/// entries.
+///
+/// Pools of tags (see IsTagComponent) have no pages. They only keep track of
+/// which entities have the tag, and every slot's address is that of a single
+/// instance of the tag that the pool owns. Tag pools can't be double buffered
+class ComponentPool
+{
+  /// \brief Constructor
+  /// \param[in] _metadata The type of component stored in the pool
+  public: explicit ComponentPool(const ComponentMetadata &_metadata);
+
+  /// \brief Destructor
+  public: ~ComponentPool();
+
+  /// \brief Pools own raw memory, so they can't be copied
+  public: ComponentPool(const ComponentPool &) = delete;
+
+  /// \brief Pools own raw memory, so they can't be copied
+  public: ComponentPool &operator=(const ComponentPool &) = delete;
+
+  /// \brief Get the type of component stored in the pool
+  /// \return The component metadata
+  public: const ComponentMetadata &Metadata() const;
+
+  /// \brief Get the number of components in the pool
+  /// \return The number of components
+  public: std::size_t Size() const;
+
+  /// \brief Get the number of slots that have been handed out, which includes
+  /// both slots holding a component and slots that are waiting to be re-used
+  /// \return The number of slots
+  public: std::size_t SlotCount() const;
+
+  /// \brief Get the number of components the pool can hold without allocating
+  /// another page
+  /// \return The capacity of the pool
+  public: std::size_t Capacity() const;
+
+  /// \brief Check if an entity has a component in the pool
+  /// \param[in] _entity The entity
+  /// \return true if _entity has a component in the pool, false otherwise
+  public: bool Has(const Entity &_entity) const;
+
+  /// \brief Get an entity's component (its current value, if the pool is
+  /// double buffered)
+  /// \param[in] _entity The entity
+  /// \return A pointer to _entity's component, or nullptr if _entity has no
+  /// component in the pool
+  public: void *Component(const Entity &_entity) const;
+
+  /// \brief Get the storage address of an entity's component, which is the
+  /// address of the component's current value offset by -CurrentOffset()
+  /// \param[in] _entity The entity
+  /// \return The storage address, or nullptr if _entity has no component in
+  /// the pool
+  public: void *ComponentStorage(const Entity &_entity) const;
+
+  /// \brief Get the slot that holds an entity's component
+  /// \param[in] _entity The entity
+  /// \return The slot, or kInvalidSlot if _entity has no component in the pool
+  public: std::size_t Slot(const Entity &_entity) const;
+
+  /// \brief Copy a component into the pool. It is assumed that the entity does
+  /// not already have a component in the pool
+  /// \param[in] _entity The entity that owns the component
+  /// \param[in] _component The component to copy
+  /// \return A pointer to the component that is stored in the pool
+  public: void *Add(const Entity &_entity, const void *_component);
+
+  /// \brief Remove an entity's component from the pool, if it exists
+  /// \param[in] _entity The entity
+  public: void Remove(const Entity &_entity);
+
+  /// \brief Move the components of a set of entities out of the pool and
+  /// into a column. Entities without a component in the pool are skipped. If
+  /// the pool is double buffered, only the current values are moved
+  /// \param[in] _entities The entities
+  /// \param[in] _column The column to append the components to
+  public: void Extract(const std::vector<Entity> &_entities,
+              ComponentColumn &_column);
+
+  /// \brief Move all of the components of a column into the pool. The
+  /// components are stored after the last slot in column order, so that each
+  /// page worth of them is moved at once (slots that were freed before aren't
+  /// re-used; Compact releases them). None of the column's entities may
+  /// already have a component in the pool. The column is left empty
+  /// \param[in] _column The column
+  public: void Insert(ComponentColumn &_column);
+
+  /// \brief Swap the contents of two slots (either of which may be unused).
+  /// Pointers to the components in the two slots are invalidated
+  /// \param[in] _a A slot, which must be less than SlotCount()
+  /// \param[in] _b Another slot, which must be less than SlotCount()
+  public: void SwapSlots(const std::size_t _a, const std::size_t _b);
+
+  /// \brief Move the components into as few slots as possible, in a
+  /// particular order. The components of the entities in _order are moved to
+  /// the first slots (in that order), followed by the remaining components in
+  /// their current slot order. Unused slots and pages are released. Pointers
+  /// to the pool's components are invalidated
+  /// \param[in] _order Entities whose components should be stored first.
+  /// Entities without a component in the pool are ignored
+  public: void Compact(const std::vector<Entity> &_order);
+
+  /// \brief Get the entity that owns the component in a slot
+  /// \param[in] _slot The slot, which must be less than SlotCount()
+  /// \return The entity, or kNullEntity if the slot is unused
+  public: Entity SlotEntity(const std::size_t _slot) const;
+
+  /// \brief Get the entities that own the components in the slots, which are
+  /// stored contiguously
+  /// \return A pointer to the entity of slot 0 (followed by the entities of
+  /// the other slots, up to SlotCount())
+  public: const Entity *SlotEntities() const;
+
+  /// \brief Get the address of a slot (of its current value, if the pool is
+  /// double buffered)
+  /// \param[in] _slot The slot, which must be less than Capacity()
+  /// \return The address of the slot
+  public: void *SlotData(const std::size_t _slot) const;
+
+  /// \brief Get the address of the next value of a slot. This is the same as
+  /// SlotData if the pool isn't double buffered
+  /// \param[in] _slot The slot, which must be less than Capacity()
+  /// \return The address of the slot's next value
+  public: void *NextSlotData(const std::size_t _slot) const;
+
+  /// \brief Turn double buffering on or off. When it's turned on, the next
+  /// value of every component starts out as a copy of the current value. When
+  /// it's turned off, the next values are discarded. Pointers to the pool's
+  /// components are invalidated
+  /// \param[in] _doubleBuffered Whether the pool should be double buffered
+  public: void SetDoubleBuffered(const bool _doubleBuffered);
+
+  /// \brief Check if the pool is double buffered
+  /// \return true if the pool is double buffered, false otherwise
+  public: bool DoubleBuffered() const;
+
+  /// \brief Make the next value of every component its current value, and
+  /// the current value its next value. Only the roles of the page halves
+  /// change, so this takes constant time. Nothing happens if the pool isn't
+  /// double buffered
+  public: void SwapBuffers();
+
+  /// \brief Allocate pages from huge page mappings, or from the heap again.
+  /// The components are moved to new pages, so pointers to the pool's
+  /// components are invalidated. Nothing happens if huge pages aren't
+  /// supported (see kHugePagesSupported)
+  /// \param[in] _hugePages Whether pages should be allocated from huge page
+  /// mappings
+  public: void SetHugePages(const bool _hugePages);
+
+  /// \brief Check if pages are allocated from huge page mappings
+  /// \return true if they are, false otherwise
+  public: bool HugePages() const;
+
+  /// \brief Get the offset from a component's storage address to its
+  /// current value
+  /// \return The offset in bytes (always 0 if the pool isn't double buffered)
+  public: std::ptrdiff_t CurrentOffset() const;
+
+  /// \brief Get the offset from a component's storage address to its next
+  /// value
+  /// \return The offset in bytes (always 0 if the pool isn't double buffered)
+  public: std::ptrdiff_t NextOffset() const;
+
+  /// \brief Get the memory used by the pool
+  /// \return The pool's memory stats
+  public: ComponentMemoryStats MemoryStats() const;
+
+  /// \brief The number of components stored in a page
+  public: constexpr const static std::size_t kPageSize{1024};
+
+  /// \brief Returned by Slot for entities without a component in the pool
+  public: constexpr const static std::size_t kInvalidSlot{
+            std::numeric_limits<std::size_t>::max()};
+
+  /// \brief Allocate another page of slots
+  private: void AllocatePage();
+
+  /// \brief Free a page that was allocated by AllocatePage
+  /// \param[in] _page The page
+  /// \param[in] _bytes The size of the page
+  private: void FreePage(unsigned char *_page, const std::size_t _bytes);
+
+  /// \brief Move the components to new pages, which are allocated after
+  /// changing how pages are allocated or how many buffers they have. The
+  /// current values end up in the first half of each page
+  /// \param[in] _change Changes how pages are allocated or how many buffers
+  /// they have. The arena that the old pages were allocated from (if any)
+  /// must outlive the call
+  private: template<typename ChangeT>
+           void Reallocate(ChangeT &&_change);
+
+  /// \brief Find the slot that holds an entity's component
+  /// \param[in] _entity The entity
+  /// \return The slot, or kInvalidSlot if _entity has no component in the
+  /// pool
+  private: std::size_t FindSlot(const Entity &_entity) const;
+
+  /// \brief Record the slot that holds an entity's component
+  /// \param[in] _entity The entity
+  /// \param[in] _slot The slot
+  private: void SetSlot(const Entity &_entity, const std::size_t _slot);
+
+  /// \brief Forget the slot of an entity's component
+  /// \param[in] _entity The entity, which must have a component in the pool
+  private: void EraseSlot(const Entity &_entity);
+
+  /// \brief Get the storage address of a slot (the slot's address in the
+  /// first half of its page)
+  /// \param[in] _slot The slot, which must be less than Capacity()
+  /// \return The storage address
+  private: unsigned char *StorageData(const std::size_t _slot) const;
+
+  /// \brief Get the number of buffers (halves) in each page
+  /// \return 2 if the pool is double buffered, 1 otherwise
+  private: std::size_t BufferCount() const;
+
+  /// \brief Get the size of one buffer of a page
+  /// \return The size in bytes
+  private: std::size_t BufferBytes() const;
+
+  /// \brief The type of component stored in the pool
+  private: const ComponentMetadata &metadata;
+
+  /// \brief The pages of component memory. Each page holds kPageSize
+  /// components
+  private: std::vector<unsigned char *> pages;
+
+  /// \brief The entity that owns the component in each slot (kNullEntity for
+  /// slots that are unused)
+  private: std::vector<Entity> slotEntities;
+
+  /// \brief Slots that are unused and can be given to new components
+  private: std::vector<std::size_t> freeSlots;
+
+  /// \brief A map of an entity to the slot that holds its component (unused
+  /// by tag pools)
+  private: std::unordered_map<Entity, std::size_t> entitySlots;
+
+  /// \brief The number of entities in a page of tagSlots
+  private: constexpr const static std::size_t kTagPageSize{4096};
+
+  /// \brief Used in tagSlots for entities without the tag
+  private: constexpr const static std::uint32_t kNoTag{
+             std::numeric_limits<std::uint32_t>::max()};
+
+  /// \brief The slot of every entity in a tag pool. Entities are split into
+  /// pages of kTagPageSize consecutive ids, and a page is allocated once one
+  /// of its entities gets the tag. Since entity ids are handed out in order,
+  /// this takes about 4 bytes per entity instead of a hash map node
+  private: std::unordered_map<Entity, std::vector<std::uint32_t>> tagSlots;
+
+  /// \brief The instance that every slot of a tag pool points at
+  private: unsigned char *tagInstance{nullptr};
+
+  /// \brief Memory for a single component, which is used when swapping slots
+  /// (allocated on first use)
+  private: unsigned char *scratch{nullptr};
+
+  /// \brief Whether the pool is double buffered
+  private: bool doubleBuffered{false};
+
+  /// \brief The page half that holds the current values (0 or 1). The other
+  /// half holds the next values
+  private: std::size_t currentBuffer{0};
+
+  /// \brief The arena that pages are allocated from, or nullptr if pages are
+  /// allocated from the heap
+  private: std::unique_ptr<HugePageArena> arena;
+};
+
+ComponentColumn::ComponentColumn(const ComponentMetadata &_metadata)
+  : metadata(&_metadata)
+{
+}
+
+ComponentColumn::ComponentColumn(ComponentColumn &&_other) noexcept
+  : metadata(_other.metadata), entities(std::move(_other.entities)),
+    data(_other.data), capacity(_other.capacity)
+{
+  _other.entities.clear();
+  _other.data = nullptr;
+  _other.capacity = 0;
+}
+
+ComponentColumn::~ComponentColumn()
+{
+  if (this->data)
+  {
+    DestroyComponents(*this->metadata, this->data, this->Size());
+    ::operator delete(this->data,
+        std::align_val_t{this->metadata->alignment});
+  }
+}
+
+const ComponentMetadata &ComponentColumn::Metadata() const
+{
+  return *this->metadata;
+}
+
+std::size_t ComponentColumn::Size() const
+{
+  return this->entities.size();
+}
+
+const std::vector<Entity> &ComponentColumn::Entities() const
+{
+  return this->entities;
+}
+
+void *ComponentColumn::Data(const std::size_t _index) const
+{
+  if (!this->data)
+    return nullptr;
+  return this->data + _index * this->metadata->size;
+}
+
+void ComponentColumn::Reserve(const std::size_t _count)
+{
+  if (_count <= this->capacity)
+    return;
+
+  // tags have no data to store
+  if (this->metadata->tag)
+  {
+    this->capacity = _count;
+    this->entities.reserve(_count);
+    return;
+  }
+
+  auto newData = static_cast<unsigned char *>(::operator new(
+        _count * this->metadata->size,
+        std::align_val_t{this->metadata->alignment}));
+  if (this->data)
+  {
+    RelocateComponents(*this->metadata, newData, this->data, this->Size());
+    ::operator delete(this->data,
+        std::align_val_t{this->metadata->alignment});
+  }
+  this->data = newData;
+  this->capacity = _count;
+  this->entities.reserve(_count);
+}
+
+void *ComponentColumn::Append(const Entity &_entity)
+{
+  if (this->Size() == this->capacity)
+    this->Reserve(std::max<std::size_t>(16, this->capacity * 2));
+  this->entities.push_back(_entity);
+  return this->Data(this->Size() - 1);
+}
+
+void ComponentColumn::Release()
+{
+  this->entities.clear();
+}
+
+ComponentPool::ComponentPool(const ComponentMetadata &_metadata)
+  : metadata(_metadata)
+{
+  if (this->metadata.tag)
+  {
+    this->tagInstance = static_cast<unsigned char *>(::operator new(
+          this->metadata.size, std::align_val_t{this->metadata.alignment}));
+    this->metadata.construct(this->tagInstance);
+  }
+}
+
+ComponentPool::~ComponentPool()
+{
+  for (const auto &[entity, slot] : this->entitySlots)
+  {
+    for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+    {
+      DestroyComponents(this->metadata,
+          this->StorageData(slot) + buffer * this->BufferBytes(), 1);
+    }
+  }
+
+  if (!this->arena)
+  {
+    for (auto page : this->pages)
+      ::operator delete(page, std::align_val_t{this->metadata.alignment});
+  }
+  if (this->scratch)
+  {
+    ::operator delete(this->scratch,
+        std::align_val_t{this->metadata.alignment});
+  }
+  if (this->tagInstance)
+  {
+    DestroyComponents(this->metadata, this->tagInstance, 1);
+    ::operator delete(this->tagInstance,
+        std::align_val_t{this->metadata.alignment});
+  }
+}
+
+const ComponentMetadata &ComponentPool::Metadata() const
+{
+  return this->metadata;
+}
+
+std::size_t ComponentPool::Size() const
+{
+  return this->slotEntities.size() - this->freeSlots.size();
+}
+
+std::size_t ComponentPool::SlotCount() const
+{
+  return this->slotEntities.size();
+}
+
+std::size_t ComponentPool::Capacity() const
+{
+  return this->pages.size() * kPageSize;
+}
+
+bool ComponentPool::Has(const Entity &_entity) const
+{
+  return this->FindSlot(_entity) != kInvalidSlot;
+}
+
+void *ComponentPool::Component(const Entity &_entity) const
+{
+  const auto slot = this->FindSlot(_entity);
+  if (slot == kInvalidSlot)
+    return nullptr;
+  return this->SlotData(slot);
+}
+
+void *ComponentPool::ComponentStorage(const Entity &_entity) const
+{
+  const auto slot = this->FindSlot(_entity);
+  if (slot == kInvalidSlot)
+    return nullptr;
+  return this->StorageData(slot);
+}
+
+std::size_t ComponentPool::Slot(const Entity &_entity) const
+{
+  return this->FindSlot(_entity);
+}
+
+void *ComponentPool::Add(const Entity &_entity, const void *_component)
+{
+  std::size_t slot;
+  if (!this->freeSlots.empty())
+  {
+    slot = this->freeSlots.back();
+    this->freeSlots.pop_back();
+    this->slotEntities[slot] = _entity;
+  }
+  else
+  {
+    slot = this->slotEntities.size();
+    if (slot == this->Capacity() && !this->metadata.tag)
+      this->AllocatePage();
+    this->slotEntities.push_back(_entity);
+  }
+
+  if (!this->metadata.tag)
+  {
+    for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+    {
+      CopyComponents(this->metadata,
+          this->StorageData(slot) + buffer * this->BufferBytes(),
+          _component, 1);
+    }
+  }
+  this->SetSlot(_entity, slot);
+  return this->SlotData(slot);
+}
+
+void ComponentPool::Remove(const Entity &_entity)
+{
+  const auto slot = this->FindSlot(_entity);
+  if (slot == kInvalidSlot)
+    return;
+
+  if (!this->metadata.tag)
+  {
+    for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+    {
+      DestroyComponents(this->metadata,
+          this->StorageData(slot) + buffer * this->BufferBytes(), 1);
+    }
+  }
+  this->slotEntities[slot] = kNullEntity;
+  this->freeSlots.push_back(slot);
+  this->EraseSlot(_entity);
+}
+
+void ComponentPool::Extract(const std::vector<Entity> &_entities,
+    ComponentColumn &_column)
+{
+  _column.Reserve(_column.Size() + std::min(_entities.size(), this->Size()));
+  for (const auto &entity : _entities)
+  {
+    const auto slot = this->FindSlot(entity);
+    if (slot == kInvalidSlot)
+      continue;
+
+    auto dst = _column.Append(entity);
+    if (!this->metadata.tag)
+      RelocateComponents(this->metadata, dst, this->SlotData(slot), 1);
+    if (this->doubleBuffered)
+      DestroyComponents(this->metadata, this->NextSlotData(slot), 1);
+    this->slotEntities[slot] = kNullEntity;
+    this->freeSlots.push_back(slot);
+    this->EraseSlot(entity);
+  }
+}
+
+void ComponentPool::Insert(ComponentColumn &_column)
+{
+  const auto count = _column.Size();
+  const auto first = this->SlotCount();
+  while (!this->metadata.tag && this->Capacity() < first + count)
+    this->AllocatePage();
+  this->slotEntities.insert(this->slotEntities.end(),
+      _column.Entities().begin(), _column.Entities().end());
+  if (!this->metadata.tag)
+    this->entitySlots.reserve(this->entitySlots.size() + count);
+
+  // move a run of components per page
+  std::size_t index = 0;
+  while (!this->metadata.tag && index < count)
+  {
+    const auto slot = first + index;
+    const auto run =
+      std::min(count - index, kPageSize - slot % kPageSize);
+    RelocateComponents(this->metadata, this->SlotData(slot),
+        _column.Data(index), run);
+    if (this->doubleBuffered)
+    {
+      CopyComponents(this->metadata, this->NextSlotData(slot),
+          this->SlotData(slot), run);
+    }
+    index += run;
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+    this->SetSlot(_column.Entities()[i], first + i);
+  _column.Release();
+}
+
+void ComponentPool::SwapSlots(const std::size_t _a, const std::size_t _b)
+{
+  const auto entityA = this->slotEntities[_a];
+  const auto entityB = this->slotEntities[_b];
+  if (_a == _b || (entityA == kNullEntity && entityB == kNullEntity))
+    return;
+
+  if (this->metadata.tag)
+  {
+    // there is no data to move
+    if (entityA != kNullEntity)
+      this->SetSlot(entityA, _b);
+    if (entityB != kNullEntity)
+      this->SetSlot(entityB, _a);
+    if (entityA == kNullEntity || entityB == kNullEntity)
+    {
+      const auto used = entityA != kNullEntity ? _a : _b;
+      const auto unused = entityA != kNullEntity ? _b : _a;
+      *std::find(this->freeSlots.begin(), this->freeSlots.end(), unused) =
+        used;
+    }
+  }
+  else if (entityA != kNullEntity && entityB != kNullEntity)
+  {
+    if (!this->scratch)
+    {
+      this->scratch = static_cast<unsigned char *>(::operator new(
+            this->metadata.size, std::align_val_t{this->metadata.alignment}));
+    }
+    for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+    {
+      const auto offset = buffer * this->BufferBytes();
+      const auto a = this->StorageData(_a) + offset;
+      const auto b = this->StorageData(_b) + offset;
+      RelocateComponents(this->metadata, this->scratch, a, 1);
+      RelocateComponents(this->metadata, a, b, 1);
+      RelocateComponents(this->metadata, b, this->scratch, 1);
+    }
+    this->SetSlot(entityA, _b);
+    this->SetSlot(entityB, _a);
+  }
+  else
+  {
+    // move the component into the unused slot
+    const auto used = entityA != kNullEntity ? _a : _b;
+    const auto unused = entityA != kNullEntity ? _b : _a;
+    for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+    {
+      const auto offset = buffer * this->BufferBytes();
+      RelocateComponents(this->metadata, this->StorageData(unused) + offset,
+          this->StorageData(used) + offset, 1);
+    }
+    this->SetSlot(this->slotEntities[used], unused);
+    *std::find(this->freeSlots.begin(), this->freeSlots.end(), unused) = used;
+  }
+  std::swap(this->slotEntities[_a], this->slotEntities[_b]);
+}
+
+void ComponentPool::Compact(const std::vector<Entity> &_order)
+{
+  // the current slot of each component, in the new order
+  std::vector<std::size_t> oldSlots;
+  oldSlots.reserve(this->Size());
+  std::vector<bool> placed(this->SlotCount(), false);
+  for (const auto &entity : _order)
+  {
+    const auto slot = this->FindSlot(entity);
+    if (slot == kInvalidSlot || placed[slot])
+      continue;
+    oldSlots.push_back(slot);
+    placed[slot] = true;
+  }
+  for (std::size_t slot = 0; slot < this->SlotCount(); ++slot)
+  {
+    if (!placed[slot] && this->slotEntities[slot] != kNullEntity)
+      oldSlots.push_back(slot);
+  }
+
+  auto oldPages = std::move(this->pages);
+  this->pages.clear();
+  const auto oldSlotEntities = std::move(this->slotEntities);
+  this->slotEntities.clear();
+  this->slotEntities.reserve(oldSlots.size());
+  for (std::size_t slot = 0; slot < oldSlots.size(); ++slot)
+  {
+    const auto oldSlot = oldSlots[slot];
+    const auto entity = oldSlotEntities[oldSlot];
+    if (!this->metadata.tag)
+    {
+      if (slot == this->Capacity())
+        this->AllocatePage();
+      for (std::size_t buffer = 0; buffer < this->BufferCount(); ++buffer)
+      {
+        const auto offset = buffer * this->BufferBytes();
+        RelocateComponents(this->metadata, this->StorageData(slot) + offset,
+            oldPages[oldSlot / kPageSize] +
+              (oldSlot % kPageSize) * this->metadata.size + offset, 1);
+      }
+    }
+    this->slotEntities.push_back(entity);
+    this->SetSlot(entity, slot);
+  }
+
+  for (auto page : oldPages)
+    this->FreePage(page, this->BufferBytes() * this->BufferCount());
+  this->freeSlots.clear();
+  this->freeSlots.shrink_to_fit();
+}
+
+Entity ComponentPool::SlotEntity(const std::size_t _slot) const
+{
+  return this->slotEntities[_slot];
+}
+
+const Entity *ComponentPool::SlotEntities() const
+{
+  return this->slotEntities.data();
+}
+
+void *ComponentPool::SlotData(const std::size_t _slot) const
+{
+  return this->StorageData(_slot) + this->CurrentOffset();
+}
+
+void *ComponentPool::NextSlotData(const std::size_t _slot) const
+{
+  return this->StorageData(_slot) + this->NextOffset();
+}
+
+void ComponentPool::SetDoubleBuffered(const bool _doubleBuffered)
+{
+  // tags have no values, so there is nothing to buffer
+  if (_doubleBuffered == this->doubleBuffered || this->metadata.tag)
+    return;
+
+  this->Reallocate([this, _doubleBuffered]()
+      {
+        this->doubleBuffered = _doubleBuffered;
+      });
+}
+
+bool ComponentPool::DoubleBuffered() const
+{
+  return this->doubleBuffered;
+}
+
+void ComponentPool::SwapBuffers()
+{
+  if (this->doubleBuffered)
+    this->currentBuffer ^= 1;
+}
+
+void ComponentPool::SetHugePages(const bool _hugePages)
+{
+  if (!kHugePagesSupported || _hugePages == this->HugePages())
+    return;
+
+  // the arena has to outlive the old pages, which are freed after the
+  // components are moved out of them
+  std::unique_ptr<HugePageArena> oldArena;
+  this->Reallocate([this, _hugePages, &oldArena]()
+      {
+        oldArena = std::move(this->arena);
+        if (_hugePages)
+          this->arena = std::make_unique<HugePageArena>();
+      });
+}
+
+bool ComponentPool::HugePages() const
+{
+  return this->arena != nullptr;
+}
+
+std::ptrdiff_t ComponentPool::CurrentOffset() const
+{
+  return static_cast<std::ptrdiff_t>(this->currentBuffer * this->BufferBytes());
+}
+
+std::ptrdiff_t ComponentPool::NextOffset() const
+{
+  if (!this->doubleBuffered)
+    return 0;
+  return static_cast<std::ptrdiff_t>(
+      (this->currentBuffer ^ 1) * this->BufferBytes());
+}
+
+ComponentMemoryStats ComponentPool::MemoryStats() const
+{
+  ComponentMemoryStats stats;
+  stats.typeId = this->metadata.typeId;
+  stats.name = this->metadata.name;
+  stats.count = this->Size();
+  if (this->metadata.tag)
+  {
+    // the shared instance is the only component data
+    stats.dataBytes = this->metadata.size;
+    stats.indexBytes = UnorderedMemoryBytes(this->tagSlots) +
+      VectorMemoryBytes(this->slotEntities) +
+      VectorMemoryBytes(this->freeSlots);
+    for (const auto &[page, slots] : this->tagSlots)
+      stats.indexBytes += VectorMemoryBytes(slots);
+    return stats;
+  }
+  stats.dataBytes = this->Size() * this->metadata.size * this->BufferCount();
+  stats.slackBytes = (this->Capacity() - this->Size()) * this->metadata.size *
+    this->BufferCount();
+  stats.indexBytes = VectorMemoryBytes(this->pages) +
+    VectorMemoryBytes(this->slotEntities) +
+    VectorMemoryBytes(this->freeSlots) +
+    UnorderedMemoryBytes(this->entitySlots);
+  if (this->arena)
+    stats.hugePageBytes = this->arena->HugePageBytes();
+  return stats;
+}
+
+void ComponentPool::AllocatePage()
+{
+  const auto bytes = this->BufferBytes() * this->BufferCount();
+  if (this->arena)
+  {
+    this->pages.push_back(
+        this->arena->Allocate(bytes, this->metadata.alignment));
+    return;
+  }
+  this->pages.push_back(static_cast<unsigned char *>(
+        ::operator new(bytes, std::align_val_t{this->metadata.alignment})));
+}
+
+void ComponentPool::FreePage(unsigned char *_page, const std::size_t _bytes)
+{
+  if (this->arena)
+    this->arena->Free(_page, _bytes);
+  else
+    ::operator delete(_page, std::align_val_t{this->metadata.alignment});
+}
+
+template<typename ChangeT>
+void ComponentPool::Reallocate(ChangeT &&_change)
+{
+  // move the current values into new pages. The current values end up in
+  // the first half, and if the pool is (still) double buffered, the next
+  // values are copies of them
+  auto oldPages = std::move(this->pages);
+  this->pages.clear();
+  const auto oldPageBytes = this->BufferBytes() * this->BufferCount();
+  const auto oldCurrentOffset = this->CurrentOffset();
+  const auto oldNextOffset = this->NextOffset();
+  const auto oldDoubleBuffered = this->doubleBuffered;
+  const auto oldArena = this->arena.get();
+  _change();
+  this->currentBuffer = 0;
+  for (std::size_t p = 0; p < oldPages.size(); ++p)
+    this->AllocatePage();
+
+  for (const auto &[entity, slot] : this->entitySlots)
+  {
+    auto oldStorage = oldPages[slot / kPageSize] +
+      (slot % kPageSize) * this->metadata.size;
+    RelocateComponents(this->metadata, this->StorageData(slot),
+        oldStorage + oldCurrentOffset, 1);
+    if (this->doubleBuffered)
+    {
+      if (oldDoubleBuffered)
+      {
+        RelocateComponents(this->metadata,
+            this->StorageData(slot) + this->BufferBytes(),
+            oldStorage + oldNextOffset, 1);
+      }
+      else
+      {
+        CopyComponents(this->metadata,
+            this->StorageData(slot) + this->BufferBytes(),
+            this->StorageData(slot), 1);
+      }
+    }
+    else if (oldDoubleBuffered)
+    {
+      // the old next value is discarded
+      DestroyComponents(this->metadata, oldStorage + oldNextOffset, 1);
+    }
+  }
+
+  for (auto page : oldPages)
+  {
+    if (oldArena)
+      oldArena->Free(page, oldPageBytes);
+    else
+      ::operator delete(page, std::align_val_t{this->metadata.alignment});
+  }
+}
+
+std::size_t ComponentPool::FindSlot(const Entity &_entity) const
+{
+  if (this->metadata.tag)
+  {
+    auto iter = this->tagSlots.find(_entity / kTagPageSize);
+    if (iter == this->tagSlots.end())
+      return kInvalidSlot;
+    const auto slot = iter->second[_entity % kTagPageSize];
+    return slot == kNoTag ? kInvalidSlot : slot;
+  }
+
+  auto iter = this->entitySlots.find(_entity);
+  if (iter == this->entitySlots.end())
+    return kInvalidSlot;
+  return iter->second;
+}
+
+void ComponentPool::SetSlot(const Entity &_entity, const std::size_t _slot)
+{
+  if (!this->metadata.tag)
+  {
+    this->entitySlots[_entity] = _slot;
+    return;
+  }
+
+  auto &page = this->tagSlots[_entity / kTagPageSize];
+  if (page.empty())
+    page.assign(kTagPageSize, kNoTag);
+  page[_entity % kTagPageSize] = static_cast<std::uint32_t>(_slot);
+}
+
+void ComponentPool::EraseSlot(const Entity &_entity)
+{
+  if (!this->metadata.tag)
+  {
+    this->entitySlots.erase(_entity);
+    return;
+  }
+
+  // pages aren't released when they become empty, since entities that are
+  // close to each other tend to be tagged again
+  this->tagSlots[_entity / kTagPageSize][_entity % kTagPageSize] = kNoTag;
+}
+
+unsigned char *ComponentPool::StorageData(const std::size_t _slot) const
+{
+  if (this->metadata.tag)
+    return this->tagInstance;
+  return this->pages[_slot / kPageSize] +
+    (_slot % kPageSize) * this->metadata.size;
+}
+
+std::size_t ComponentPool::BufferCount() const
+{
+  return this->doubleBuffered ? 2 : 1;
+}
+
+std::size_t ComponentPool::BufferBytes() const
+{
+  return kPageSize * this->metadata.size;
+}
+
+#endif
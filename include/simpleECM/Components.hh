@@ -2,8 +2,8 @@
 #define COMPONENTS_HH_
 
 #include <ostream>
-#include <string>
 
+#include "simpleECM/InternedString.hh"
 #include "simpleECM/Types.hh"
 
 /// \brief A base component type, which should be inherited by other components
@@ -26,9 +26,12 @@ struct BaseComponent
   public: virtual ComponentTypeId DerivedTypeId() const = 0;
 
   public: constexpr const static ComponentTypeId typeId{kInvalidComponent};
+  public: constexpr const static char *typeName{"BaseComponent"};
 };
 
-/// \brief A component that contains the name of the entity
+/// \brief A component that contains the name of the entity. The name is
+/// interned (see InternedString), so the component only holds a handle into a
+/// table of names that is shared by every entity
 struct Name : public BaseComponent
 {
   private: std::ostream &ToOStream(std::ostream &_os) const
@@ -42,8 +45,9 @@ struct Name : public BaseComponent
     return this->typeId;
   }
 
-  public: std::string name;
+  public: InternedString name;
   public: constexpr const static ComponentTypeId typeId{1};
+  public: constexpr const static char *typeName{"Name"};
 };
 
 /// \brief A component that identifies an entity as a world
@@ -61,6 +65,7 @@ struct World : public BaseComponent
   }
 
   public: constexpr const static ComponentTypeId typeId{2};
+  public: constexpr const static char *typeName{"World"};
 };
 
 /// \brief A component that defines whether an entity is static or not
@@ -82,6 +87,7 @@ struct Static : public BaseComponent
 
   public: bool isStatic;
   public: constexpr const static ComponentTypeId typeId{3};
+  public: constexpr const static char *typeName{"Static"};
 };
 
 /// \brief A component representing an entity's position
@@ -100,6 +106,7 @@ struct Position : public BaseComponent
 
   public: Vector3i data;
   public: constexpr const static ComponentTypeId typeId{4};
+  public: constexpr const static char *typeName{"Position"};
 };
 
 /// \brief A component representing an entity's position in world coordinates
@@ -111,6 +118,7 @@ struct WorldPosition : public Position
   }
 
   public: constexpr const static ComponentTypeId typeId{5};
+  public: constexpr const static char *typeName{"WorldPosition"};
 };
 
 /// \brief A component representing an entity's linear velocity
@@ -129,6 +137,7 @@ struct LinearVelocity : public BaseComponent
 
   public: Vector3i data;
   public: constexpr const static ComponentTypeId typeId{6};
+  public: constexpr const static char *typeName{"LinearVelocity"};
 };
 
 /// \brief A component representing an entity's linear velocity in world
@@ -141,6 +150,7 @@ struct WorldLinearVelocity : public LinearVelocity
   }
 
   public: constexpr const static ComponentTypeId typeId{7};
+  public: constexpr const static char *typeName{"WorldLinearVelocity"};
 };
 
 /// \brief A component representing an entity's angular velocity
@@ -159,6 +169,7 @@ struct AngularVelocity : public BaseComponent
 
   public: Vector3i data;
   public: constexpr const static ComponentTypeId typeId{8};
+  public: constexpr const static char *typeName{"AngularVelocity"};
 };
 
 /// \brief A component representing an entity's angular velocity in world
@@ -171,6 +182,7 @@ struct WorldAngularVelocity : public AngularVelocity
   }
 
   public: constexpr const static ComponentTypeId typeId{9};
+  public: constexpr const static char *typeName{"WorldAngularVelocity"};
 };
 
 /// \brief A component representing an entity's linear acceleration
@@ -189,6 +201,7 @@ struct LinearAcceleration : public BaseComponent
 
   public: Vector3i data;
   public: constexpr const static ComponentTypeId typeId{10};
+  public: constexpr const static char *typeName{"LinearAcceleration"};
 };
 
 /// \brief A component representing an entity's linear acceleration in world
@@ -201,6 +214,7 @@ struct WorldLinearAcceleration : public LinearAcceleration
   }
 
   public: constexpr const static ComponentTypeId typeId{11};
+  public: constexpr const static char *typeName{"WorldLinearAcceleration"};
 };
 
 /// \brief A component representing an entity's pose
@@ -220,6 +234,7 @@ struct Pose : public BaseComponent
   public: Vector3i position;
   public: Quaternioni orientation;
   public: constexpr const static ComponentTypeId typeId{12};
+  public: constexpr const static char *typeName{"Pose"};
 };
 
 /// \brief A component representing an entity's pose in world coordinates
@@ -231,6 +246,7 @@ struct WorldPose : public Pose
   }
 
   public: constexpr const static ComponentTypeId typeId{13};
+  public: constexpr const static char *typeName{"WorldPose"};
 };
 
 #endif
@@ -1,24 +1,152 @@
 #ifndef ECM_HH_
 #define ECM_HH_
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "simpleECM/ComponentIndex.hh"
+#include "simpleECM/ComponentMetadata.hh"
+#include "simpleECM/ComponentPool.hh"
 #include "simpleECM/Components.hh"
+#include "simpleECM/HugePages.hh"
+#include "simpleECM/MemoryStats.hh"
+#include "simpleECM/SpatialIndex.hh"
+#include "simpleECM/Trace.hh"
 #include "simpleECM/Types.hh"
 #include "simpleECM/View.hh"
 
+/// \brief Entities that were taken out of an ECM along with all of their
+/// components (see ECM::ExtractEntities)
+struct EntityBatch
+{
+  /// \brief The entities
+  std::vector<Entity> entities;
+
+  /// \brief The components of the entities, with a column per component type
+  std::vector<ComponentColumn> columns;
+};
+
+/// \brief How much work a single EachBudgeted call may do
+struct EachBudget
+{
+  /// \brief The maximum number of entities to visit, or 0 for no limit
+  std::size_t maxEntities{0};
+
+  /// \brief The maximum time to spend visiting entities, or 0 for no limit.
+  /// The time is checked every few entities, so a call can run over by the
+  /// time it takes to visit them
+  std::chrono::nanoseconds maxTime{0};
+};
+
+/// \brief Where a series of EachBudgeted calls is in its pass over the
+/// entities of a query. A pass starts with a snapshot of the entities that
+/// match the query, and every call visits the next entities of the snapshot
+/// until its budget runs out. Entities that lose one of the query's
+/// components before they're reached are skipped, and entities that gain the
+/// query's components are visited in the next pass, so every entity that
+/// matches the query for a whole pass is visited exactly once in it
+class EachCursor
+{
+  /// \brief Check if a pass is in progress
+  /// \return true if the next EachBudgeted call continues a pass, false if it
+  /// starts a new one
+  public: bool InPass() const
+  {
+    return this->inPass;
+  }
+
+  /// \brief Get the number of entities of the current pass that haven't been
+  /// reached yet (including entities that will be skipped)
+  /// \return The number of entities
+  public: std::size_t Remaining() const
+  {
+    return this->remaining.size();
+  }
+
+  /// \brief Get the number of passes that have been completed
+  /// \return The number of passes
+  public: std::uint64_t Passes() const
+  {
+    return this->passes;
+  }
+
+  /// \brief Abandon the current pass, so the next EachBudgeted call starts a
+  /// new one
+  public: void Reset()
+  {
+    this->remaining.clear();
+    this->inPass = false;
+  }
+
+  /// \brief The component types of the query the cursor is used with
+  private: std::vector<ComponentTypeId> types;
+
+  /// \brief The entities of the current pass that haven't been reached, in
+  /// reverse visiting order, along with the view row each entity was in when
+  /// the pass started (which saves looking the entity up if the view hasn't
+  /// changed since)
+  private: std::vector<std::pair<Entity, std::size_t>> remaining;
+
+  /// \brief Whether a pass is in progress
+  private: bool inPass{false};
+
+  /// \brief The number of completed passes
+  private: std::uint64_t passes{0};
+
+  friend class ECM;
+};
+
 class ECM
 {
+  /// \brief Constructor
+  public: ECM() = default;
+
+  /// \brief Constructor for an ECM whose entities are numbered from a
+  /// particular entity. ECMs that exchange entities (see ExtractEntities) must
+  /// create entities from separate ranges, so that entities never collide
+  /// \param[in] _firstEntity The entity returned by the first CreateEntity
+  /// call
+  public: explicit ECM(const Entity _firstEntity);
+
   /// \brief Create an Entity
   /// \return The Entity that was created
   public: Entity CreateEntity();
 
-  /// \brief Add a component to an entity (the entity must already exist)
+  /// \brief Take entities out of the ECM along with all of their components.
+  /// Components are moved into a column per component type, rather than
+  /// removed one at a time, so this is much cheaper than removing each
+  /// component. Entities that don't exist are skipped
+  /// \param[in] _entities The entities
+  /// \return The entities and their components
+  /// \sa InsertEntities
+  public: EntityBatch ExtractEntities(const std::vector<Entity> &_entities);
+
+  /// \brief Add entities that were taken out of an ECM (this one or another
+  /// one) along with all of their components. Each column is moved into
+  /// component storage a page at a time. The entities keep their IDs, so they
+  /// must not exist in this ECM already (see the ECM constructor)
+  /// \param[in] _batch The entities and their components. The batch is left
+  /// empty
+  public: void InsertEntities(EntityBatch &&_batch);
+
+  /// \brief Add a component to an entity (the entity must already exist).
+  /// Only membership is stored for tags (see IsTagComponent), so _component
+  /// isn't copied, and every entity's tag is the same shared instance
   /// \param[in] _entity The entity
   /// \param[in] _component The component
   public: template<typename ComponentTypeT>
@@ -36,16 +164,651 @@ class ECM
           void Each(std::function<bool(const Entity &_entity,
                                        ComponentTypeTs*...)> _f);
 
+  /// \brief Execute a callback function on the next entities of a pass over
+  /// the entities with a set of components, until the pass ends or a budget
+  /// runs out. This spreads the work of a query over several calls (one per
+  /// frame, for example), and stays correct when components are added or
+  /// removed between calls (see EachCursor). Entities are visited in view
+  /// order, and components must not be added or removed by the callback
+  /// \param[in,out] _cursor Where the last call stopped. A cursor that was
+  /// used with another set of component types starts a new pass
+  /// \param[in] _budget How much work the call may do
+  /// \param[in] _f The callback function to be executed. The pass is paused
+  /// if it returns false
+  /// \return true if the call finished the pass, false if the pass still has
+  /// entities left
+  public: template<typename ...ComponentTypeTs>
+          bool EachBudgeted(EachCursor &_cursor, const EachBudget &_budget,
+              std::function<bool(const Entity &_entity,
+                                 ComponentTypeTs*...)> _f);
+
+  /// \brief Get a range over the entities with a set of components, for use in
+  /// a range-based for loop:
+  ///   for (const auto &[entity, pose, vel] : ecm.Query<Pose, Velocity>())
+  /// This uses the same view as Each, but without calling a std::function per
+  /// entity. Components must not be added or removed while iterating
+  /// \return The range
+  public: template<typename ...ComponentTypeTs>
+          ViewRange<ComponentTypeTs...> Query();
+
+  /// \brief Execute a callback function on blocks of entities with a set of
+  /// components. The callback gets the entities of a block and a span of
+  /// components per component type, where the i-th component of each span
+  /// belongs to the i-th entity. The components of a span are contiguous in
+  /// memory, so the callback can process a block with simple loops that the
+  /// compiler can vectorize, and is called far less often than the Each
+  /// callback. Blocks are at most a page of component storage long. They are
+  /// longest if the component types are owned by a group (see CreateGroup) or
+  /// component storage has been compacted (see Compact); otherwise, blocks
+  /// may be as short as a single entity. Tags (see IsTagComponent) can't be
+  /// iterated in blocks, since they have no per-entity storage
+  /// \param[in] _f The callback function to be executed. Iteration stops if it
+  /// returns false
+  public: template<typename ...ComponentTypeTs>
+          void EachChunk(std::function<bool(Span<const Entity> _entities,
+                                            Span<ComponentTypeTs>...)> _f);
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components, without using a view. The pool of the component type with
+  /// the fewest components is iterated, and the other pools are checked for
+  /// each of its entities, so nothing is allocated or cached. This is cheaper
+  /// than Each for one-off queries (debugging, tools, etc.), especially if
+  /// few entities have one of the components, but slower than Each for queries
+  /// that are repeated. Entities are visited in component storage order
+  /// \param[in] _f The callback function to be executed
+  public: template<typename ...ComponentTypeTs>
+          void EachTransient(std::function<bool(const Entity &_entity,
+                                                ComponentTypeTs*...)> _f) const;
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components, without changing the ECM in any way. This is the query to use
+  /// in a reader phase (see BeginReads), since it's safe to call from many
+  /// threads at once. The view that matches the component types is used if it
+  /// was brought up to date by the last Commit; otherwise, the pools are
+  /// queried like EachTransient does. Views are never created or updated
+  /// \param[in] _f The callback function to be executed
+  /// \sa Commit
+  public: template<typename ...ComponentTypeTs>
+          void EachCommitted(std::function<bool(const Entity &_entity,
+                             const ComponentTypeTs*...)> _f) const;
+
+  /// \brief A writer phase (see BeginWrites). The views are brought up to
+  /// date (see Commit) when the phase ends
+  public: class WritePhase
+  {
+    /// \brief Constructor, which waits for all reader phases to end
+    /// \param[in] _ecm The ECM
+    public: explicit WritePhase(ECM &_ecm);
+
+    /// \brief A WritePhase can't be copied, since that would commit twice
+    public: WritePhase(const WritePhase &) = delete;
+
+    /// \brief A WritePhase can't be copied, since that would commit twice
+    public: WritePhase &operator=(const WritePhase &) = delete;
+
+    /// \brief Destructor, which commits the changes and ends the phase
+    public: ~WritePhase();
+
+    /// \brief The ECM
+    private: ECM &ecm;
+
+    /// \brief Keeps reader phases from starting while the phase exists
+    private: std::unique_lock<std::shared_mutex> lock;
+  };
+
+  /// \brief Begin a writer phase, waiting for all reader phases to end first.
+  /// Only one thread can be in a writer phase, and no thread can be in a reader
+  /// phase at the same time, so the writer can use all of the ECM's functions
+  /// \return The phase, which commits and ends when it's destroyed
+  public: WritePhase BeginWrites();
+
+  /// \brief Begin a reader phase, waiting for a writer phase (including one
+  /// that is waiting to start) to end first.
+  /// Any number of threads can be in a reader phase at once, as long as they
+  /// only call const functions of the ECM (EachCommitted, EachTransient,
+  /// MemoryStats, etc.), which never change the ECM
+  /// \return A lock that ends the phase when it's released
+  public: std::shared_lock<std::shared_mutex> BeginReads() const;
+
+  /// \brief Bring every view up to date with the components that were added
+  /// since the view was last used. This is the commit point between a writer
+  /// phase and reader phases: EachCommitted only uses views that are up to
+  /// date, so views should be committed before reader phases start. This is
+  /// done automatically at the end of a writer phase
+  public: void Commit();
+
+  /// \brief Turn double buffering on or off for a component type. A double
+  /// buffered component has a current value, which is what every other
+  /// function of the ECM (Each, Query, etc.) uses, and a next value, which is
+  /// written by EachBuffered. SwapBuffers makes the next values current.
+  /// Turning double buffering on doubles the memory used by the component
+  /// type. It should be done before the simulation starts, since components
+  /// have to be moved
+  /// \param[in] _doubleBuffered Whether the component type should be double
+  /// buffered
+  /// \return true if double buffering was turned on (or off), false if a view
+  /// with the component type is in use
+  public: template<typename ComponentTypeT>
+          bool SetDoubleBuffered(const bool _doubleBuffered = true);
+
+  /// \brief Make the next values of all double buffered components their
+  /// current values. This takes constant time per double buffered component
+  /// type, and is meant to be called at the end of a simulation step. The old
+  /// current values become the next values, so a system that writes next
+  /// values should write all of them (copying the current value first, if
+  /// needed)
+  public: void SwapBuffers();
+
+  /// \brief The type of the callback function of EachBuffered. Its arguments
+  /// are the entity, the current values of its components in component type
+  /// order, and then the next values in component type order
+  public: template<typename ...ComponentTypeTs>
+          struct BufferedCallback
+  {
+    /// \brief The callback function type
+    using Type = std::function<bool(const Entity &_entity,
+                                    const ComponentTypeTs*...,
+                                    ComponentTypeTs*...)>;
+  };
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components, giving it both the current (read only) and next (writable)
+  /// value of every component (see BufferedCallback). For component types
+  /// that are not double buffered, the current and next value are the same
+  /// component. Since the callback only reads current values and only writes
+  /// next values, the entities can be split up between threads without locks,
+  /// and the results don't depend on the number of threads
+  /// \param[in] _f The callback function to be executed. It's called from
+  /// several threads at once if _threads is more than 1, and iteration only
+  /// stops for the calling thread's share of the entities if it returns false
+  /// \param[in] _threads The number of threads to use (the calling thread is
+  /// one of them)
+  /// \sa SetDoubleBuffered
+  public: template<typename ...ComponentTypeTs>
+          void EachBuffered(
+              typename BufferedCallback<ComponentTypeTs...>::Type _f,
+              const std::size_t _threads = 1);
+
+  /// \brief Create a spatial index over the positions of a component type,
+  /// which lets EachInBox and EachInRadius visit only the entities that are
+  /// near the query, instead of every entity. The index is a uniform grid of
+  /// cubic cells. It's kept up to date as components are added and removed,
+  /// but the ECM can't tell when a position changes, so systems that move
+  /// entities must call UpdateSpatialIndex afterwards. The position of a
+  /// component is given by SpatialPosition (see SpatialIndex.hh), which can
+  /// be overloaded for other component types
+  /// \param[in] _cellSize The length of a cell's edge. Cells about as big as
+  /// the typical query radius work best
+  /// \return true if the index was created, false if the component type
+  /// already has a spatial index
+  public: template<typename ComponentTypeT>
+          bool CreateSpatialIndex(const int _cellSize);
+
+  /// \brief Bring the spatial index of a component type up to date with the
+  /// position of an entity. Nothing happens if the component type has no
+  /// spatial index, or the entity has no component of the type
+  /// \param[in] _entity The entity whose position changed
+  /// \return true if the entity moved to another cell of the index, false
+  /// otherwise
+  public: template<typename ComponentTypeT>
+          bool UpdateSpatialIndex(const Entity &_entity);
+
+  /// \brief Bring the spatial index of a component type up to date with the
+  /// positions of all entities. Only the entities that moved to another cell
+  /// are moved in the index, so this is much cheaper than rebuilding it
+  /// \return The number of entities that moved to another cell
+  public: template<typename ComponentTypeT>
+          std::size_t UpdateSpatialIndex();
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components whose position is in a box. The position is the one of the
+  /// first component type, which should have a spatial index (see
+  /// CreateSpatialIndex); otherwise, every component of the type is checked.
+  /// Positions are checked when the query runs, but entities are found through
+  /// the cells of the index, so an entity that moved to another cell since
+  /// the index was last updated may be missed. Components must not be added
+  /// or removed while iterating
+  /// \param[in] _min The corner of the box with the lowest coordinates
+  /// \param[in] _max The corner of the box with the highest coordinates
+  /// (inclusive)
+  /// \param[in] _f The callback function to be executed
+  public: template<typename ...ComponentTypeTs>
+          void EachInBox(const Vector3i &_min, const Vector3i &_max,
+              std::function<bool(const Entity &_entity,
+                                 ComponentTypeTs*...)> _f);
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components whose position is within a distance of a point. This works
+  /// like EachInBox
+  /// \param[in] _center The point
+  /// \param[in] _radius The distance (inclusive)
+  /// \param[in] _f The callback function to be executed
+  public: template<typename ...ComponentTypeTs>
+          void EachInRadius(const Vector3i &_center, const int _radius,
+              std::function<bool(const Entity &_entity,
+                                 ComponentTypeTs*...)> _f);
+
+  /// \brief Find an entity by the name in its Name component. Every entity
+  /// with a non-empty name is in a hash index from name to entity, which is
+  /// kept up to date as Name components are added and removed, so this takes
+  /// constant time
+  /// \param[in] _name The name
+  /// \return The entity, or kNullEntity if no entity has the name (or if the
+  /// name is empty, since unnamed entities aren't indexed). If several
+  /// entities have the name, one of them is returned
+  /// \sa SetName
+  public: Entity EntityByName(const std::string &_name) const;
+
+  /// \brief Change the name in an entity's Name component. Names should be
+  /// changed this way instead of through a component pointer, since that
+  /// would leave the name index out of date
+  /// \param[in] _entity The entity
+  /// \param[in] _name The new name
+  /// \return true if the name was changed, false if _entity has no Name
+  /// component
+  public: bool SetName(const Entity &_entity, const InternedString &_name);
+
+  /// \brief Create a secondary index over a projection of a component type
+  /// (a function that computes a key from a component, such as one of its
+  /// fields). The index finds the entities whose component has a key without
+  /// going through every component (see EachWhere and EachInRange). It's kept
+  /// up to date as components are added and removed, but the ECM can't tell
+  /// when a component changes, so changes to indexed components must be
+  /// reported with MarkModified. Every component type can have any number of
+  /// indexes
+  ///   auto moving = ecm.CreateIndex<HashIndex<Static, bool>>(
+  ///       [](const Static &_static) { return _static.isStatic; });
+  /// \param[in] _projection The function that computes the key of a
+  /// component
+  /// \return A handle to the index, for queries
+  public: template<typename IndexT>
+          IndexHandle<IndexT> CreateIndex(
+              typename IndexT::Projection _projection);
+
+  /// \brief Report that an entity's component was changed through a
+  /// component pointer, which brings the indexes of the component type (see
+  /// CreateIndex and CreateSpatialIndex) up to date with the change
+  /// \param[in] _entity The entity
+  /// \return true if the entity has a component of the type, false otherwise
+  public: template<typename ComponentTypeT>
+          bool MarkModified(const Entity &_entity);
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components whose indexed component has a key. The index drives the
+  /// query, so only the entities with the key are visited instead of every
+  /// entity with the components. Components must not be added or removed
+  /// while iterating
+  /// \param[in] _index The index (see CreateIndex)
+  /// \param[in] _key The key
+  /// \param[in] _f The callback function to be executed
+  public: template<typename ...ComponentTypeTs, typename IndexT>
+          void EachWhere(const IndexHandle<IndexT> &_index,
+              const typename IndexT::Key &_key,
+              std::function<bool(const Entity &_entity,
+                                 ComponentTypeTs*...)> _f);
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components whose indexed component has a key in a range, in key order.
+  /// This works like EachWhere, but needs an OrderedIndex
+  /// \param[in] _index The index (see CreateIndex)
+  /// \param[in] _min The lowest key
+  /// \param[in] _max The highest key (inclusive)
+  /// \param[in] _f The callback function to be executed
+  public: template<typename ...ComponentTypeTs, typename IndexT>
+          void EachInRange(const IndexHandle<IndexT> &_index,
+              const typename IndexT::Key &_min,
+              const typename IndexT::Key &_max,
+              std::function<bool(const Entity &_entity,
+                                 ComponentTypeTs*...)> _f);
+
   /// \brief Get the number of views stored in the ECM
   /// \return The number of views stored in the ECM
   public: std::size_t ViewCount() const;
 
+  /// \brief Create an owning group for a set of component types. The group
+  /// keeps the components of every entity that has all of the group's
+  /// component types (the group's members) at the front of each type's
+  /// storage, in the same order. Each calls for exactly the group's component
+  /// types (in any order) then iterate over the members by index, without a
+  /// view. Adding and removing the group's component types becomes more
+  /// expensive, since components have to be moved in and out of the group
+  /// \return true if the group was created, false if one of the component
+  /// types already belongs to a group (a component type can only belong to
+  /// one group) or is a tag (see IsTagComponent), which has no storage to
+  /// arrange
+  public: template<typename ...ComponentTypeTs>
+          bool CreateGroup();
+
+  /// \brief Create the view that matches a set of component types (in
+  /// order) ahead of time. Entities are added to a registered view as soon as
+  /// they have all of the view's components, so the first Each call that uses
+  /// the view doesn't have to build it. This is best done before entities are
+  /// created. Registered views are never evicted (see SetViewMemoryBudget),
+  /// but can be destroyed with DestroyView
+  public: template<typename ...ComponentTypeTs>
+          void RegisterView();
+
+  /// \brief Make the view that matches a set of component types (in order)
+  /// packed, or turn packing off again. Each calls that use a packed view copy
+  /// the components of every row into one contiguous buffer, run the callback
+  /// on the copies, and write the copies back. The callback then reads
+  /// components linearly, at the cost of a buffer with a copy of every row and
+  /// two extra copies per component per call. While a packed Each call is
+  /// running, its components must only be accessed through the callback's
+  /// pointers. Packing has no effect on groups, Query, EachChunk and
+  /// EachCommitted. A view that is destroyed or evicted loses its packing
+  /// \param[in] _packed Whether the view should be packed
+  public: template<typename ...ComponentTypeTs>
+          void SetViewPacked(const bool _packed);
+
+  /// \brief Destroy the view that matches a set of component types (in
+  /// order). The view is re-created the next time it's needed
+  /// \return true if the view was destroyed, false if the view doesn't exist
+  /// or is in use (for example, by an Each call that is still running)
+  public: template<typename ...ComponentTypeTs>
+          bool DestroyView();
+
+  /// \brief Destroy all views that are not in use
+  /// \return The number of views that were destroyed
+  public: std::size_t DestroyViews();
+
+  /// \brief Limit the memory used by views. When views use more than the
+  /// budget, the least recently used views are evicted (destroyed) until the
+  /// views fit in the budget again. Views that are in use are never evicted,
+  /// so the budget may be exceeded temporarily. The budget is checked whenever
+  /// a view is created or has entities added to it
+  /// \param[in] _bytes The maximum number of bytes views should use, or 0 for
+  /// no limit (the default)
+  public: void SetViewMemoryBudget(const std::size_t _bytes);
+
+  /// \brief Get the view memory budget
+  /// \return The budget in bytes, or 0 if there is no limit
+  /// \sa SetViewMemoryBudget
+  public: std::size_t ViewMemoryBudget() const;
+
+  /// \brief Get usage stats for every view that has been used, including
+  /// views that were destroyed or evicted
+  /// \return The usage stats, ordered from most to least used
+  public: std::vector<ViewUsageStats> ViewStats() const;
+
+  /// \brief Reorder component storage so that views can be iterated over
+  /// without jumping around in memory. Each component type is laid out in the
+  /// row order of the most used view that has the component type, so that the
+  /// entities of the most used views are stored contiguously, in the same
+  /// order, for all of the views' component types. Unused component storage is
+  /// released. This invalidates all component pointers, so it should be called
+  /// when the ECM isn't being used (between simulation steps, for example)
+  /// \return true if component storage was reordered, false if a view is in
+  /// use (for example, by an Each call that is still running)
+  /// \sa CompactIfNeeded
+  public: bool Compact();
+
+  /// \brief Reorder component storage like Compact(), but give priority to
+  /// the view that matches a set of component types (in order). The view is
+  /// created if it doesn't exist
+  /// \return true if component storage was reordered, false if a view is in
+  /// use
+  public: template<typename ...ComponentTypeTs>
+          bool Compact();
+
+  /// \brief Get how much component storage has changed since it was last
+  /// compacted. Adding and removing components scatters the storage of views
+  /// \return The number of components that have been added or removed since
+  /// the last compaction, as a fraction of the current number of components
+  /// \sa Compact
+  public: double LayoutChurn() const;
+
+  /// \brief Compact component storage if it has changed enough since the
+  /// last compaction. This is meant to be called whenever the application is
+  /// idle
+  /// \param[in] _minChurn Storage is compacted if LayoutChurn() is at least
+  /// _minChurn
+  /// \return true if component storage was compacted, false otherwise
+  public: bool CompactIfNeeded(const double _minChurn = 0.1);
+
+  /// \brief Allocate component storage and the rows of views from large
+  /// memory mappings that the kernel is asked to back with transparent huge
+  /// pages (or from the heap again). With millions of components, iterating
+  /// over a view touches fewer pages, so it misses the TLB less. The kernel
+  /// falls back to regular pages if huge pages are turned off or can't be
+  /// found, which MemoryStats can't tell apart (check AnonHugePages in
+  /// /proc/self/smaps). Existing components and views are moved, which
+  /// invalidates all component pointers, so this is best done before entities
+  /// are created
+  /// \param[in] _hugePages Whether huge pages should be used
+  /// \return true if the setting was applied, false if huge pages aren't
+  /// supported on this platform (see kHugePagesSupported) or a view is in
+  /// use
+  public: bool SetHugePages(const bool _hugePages);
+
+  /// \brief Check if component storage and views use huge pages
+  /// \return true if they do, false otherwise
+  /// \sa SetHugePages
+  public: bool HugePages() const;
+
+  /// \brief Get the memory used by the ECM's entity table, component storage
+  /// and views
+  /// \return The memory stats
+  public: EcmMemoryStats MemoryStats() const;
+
   /// \brief Find the view that matches a set of component types.
   /// If no view with the set of component types exists, a new one is created.
   /// \return A pointer to the view
   private: template<typename ...ComponentTypeTs>
            View<ComponentTypeTs...> *FindView();
 
+  /// \brief Implementation of EachTransient
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _pools The pool of each component type, in callback order
+  /// \param[in] _offsets An offset per component type, which is applied to the
+  /// component pointers that are passed to _f
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           void EachTransientInPools(
+               const std::function<bool(const Entity &_entity,
+                                        ComponentTypeTs*...)> &_f,
+               const std::array<ComponentPool *, sizeof...(ComponentTypeTs)>
+                 &_pools,
+               const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)>
+                 &_offsets,
+               std::index_sequence<Indices...>) const;
+
+  /// \brief Get the offsets from the component pointers that are stored in
+  /// views to the current (or next) values of the components
+  /// \param[in] _next Whether to get the offsets to the next values
+  /// \return The offset of each component type, in bytes
+  /// \sa ComponentPool::CurrentOffset
+  private: template<typename ...ComponentTypeTs>
+           std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> ViewOffsets(
+               const bool _next = false) const;
+
+  /// \brief Implementation of Each (and EachCommitted) for component types
+  /// that are iterated with a view
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _view The view
+  private: template<typename ...ComponentTypeTs, typename FunctionT,
+                    std::size_t ...Indices>
+           void EachInView(const FunctionT &_f,
+               const View<ComponentTypeTs...> &_view,
+               std::index_sequence<Indices...>) const;
+
+  /// \brief Implementation of Each for packed views (see SetViewPacked)
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _view The view
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           void EachPackedInView(
+               const std::function<bool(const Entity &_entity,
+                                        ComponentTypeTs*...)> &_f,
+               View<ComponentTypeTs...> &_view,
+               std::index_sequence<Indices...>);
+
+  /// \brief Implementation of EachBudgeted
+  /// \param[in,out] _cursor Where the last call stopped
+  /// \param[in] _budget How much work the call may do
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _view The view of the query
+  /// \return true if the call finished the pass
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           bool EachBudgetedInView(EachCursor &_cursor,
+               const EachBudget &_budget,
+               const std::function<bool(const Entity &_entity,
+                                        ComponentTypeTs*...)> &_f,
+               const View<ComponentTypeTs...> &_view,
+               std::index_sequence<Indices...>);
+
+  /// \brief Implementation of EachBuffered for a range of view rows
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _view The view
+  /// \param[in] _current The offsets to the current values (see ViewOffsets)
+  /// \param[in] _next The offsets to the next values
+  /// \param[in] _begin The first row
+  /// \param[in] _end The row after the last row
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           void EachBufferedInRows(
+               const typename BufferedCallback<ComponentTypeTs...>::Type &_f,
+               const View<ComponentTypeTs...> &_view,
+               const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)>
+                 &_current,
+               const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)>
+                 &_next,
+               const std::size_t _begin, const std::size_t _end,
+               std::index_sequence<Indices...>) const;
+
+  /// \brief Implementation of EachInBox and EachInRadius
+  /// \param[in] _min The corner of the query's bounding box with the lowest
+  /// coordinates
+  /// \param[in] _max The corner of the query's bounding box with the highest
+  /// coordinates
+  /// \param[in] _contains Checks if a position matches the query
+  /// \param[in] _f The callback function to be executed
+  private: template<typename ...ComponentTypeTs, typename ContainsT,
+                    std::size_t ...Indices>
+           void EachInRegion(const Vector3i &_min, const Vector3i &_max,
+               const ContainsT &_contains,
+               const std::function<bool(const Entity &_entity,
+                                        ComponentTypeTs*...)> &_f,
+               std::index_sequence<Indices...>);
+
+  /// \brief Execute a callback function on entities that were found through
+  /// an index, if they have a set of components
+  /// \param[in] _eachEntity Calls the function it's given on each entity that
+  /// was found, stopping if the function returns false
+  /// \param[in] _f The callback function to be executed
+  private: template<typename ...ComponentTypeTs, typename EachEntityT,
+                    std::size_t ...Indices>
+           void EachIndexed(const EachEntityT &_eachEntity,
+               const std::function<bool(const Entity &_entity,
+                                        ComponentTypeTs*...)> &_f,
+               std::index_sequence<Indices...>);
+
+  /// \brief A spatial index (see CreateSpatialIndex)
+  private: struct SpatialIndex
+  {
+    /// \brief The grid of entities
+    SpatialGrid grid;
+
+    /// \brief Get the position of a component of the indexed type
+    Vector3i (*position)(const void *_component);
+  };
+
+  /// \brief An owning group (see CreateGroup)
+  private: struct Group
+  {
+    /// \brief The component types that are owned by the group, sorted
+    std::vector<ComponentTypeId> types;
+
+    /// \brief The number of members, which are stored in the first size slots
+    /// of each owned component pool
+    std::size_t size{0};
+  };
+
+  /// \brief Find the group that owns exactly a set of component types
+  /// \return The group, or nullptr if there is no such group
+  private: template<typename ...ComponentTypeTs>
+           Group *FindGroup() const;
+
+  /// \brief Implementation of Each for component types that are owned by a
+  /// group
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _group The group
+  private: template<typename ...ComponentTypeTs, typename FunctionT,
+                    std::size_t ...Indices>
+           void EachInGroup(const FunctionT &_f, const Group &_group,
+               std::index_sequence<Indices...>) const;
+
+  /// \brief Implementation of EachChunk for component types that are owned by
+  /// a group
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _group The group
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           void EachChunkInGroup(
+               const std::function<bool(Span<const Entity> _entities,
+                                        Span<ComponentTypeTs>...)> &_f,
+               const Group &_group, std::index_sequence<Indices...>);
+
+  /// \brief Implementation of EachChunk for component types that are
+  /// iterated with a view. Blocks are runs of rows whose components are
+  /// adjacent in memory
+  /// \param[in] _f The callback function to be executed
+  /// \param[in] _view The view
+  private: template<typename ...ComponentTypeTs, std::size_t ...Indices>
+           void EachChunkInView(
+               const std::function<bool(Span<const Entity> _entities,
+                                        Span<ComponentTypeTs>...)> &_f,
+               const View<ComponentTypeTs...> &_view,
+               std::index_sequence<Indices...>);
+
+  /// \brief Check if an entity is a member of a group
+  /// \param[in] _entity The entity
+  /// \param[in] _group The group
+  /// \return true if _entity is a member of _group, false otherwise
+  private: bool IsGroupMember(const Entity &_entity, const Group &_group) const;
+
+  /// \brief Make an entity a member of a group. The entity must have all of
+  /// the group's component types
+  /// \param[in] _entity The entity
+  /// \param[in] _group The group
+  private: void JoinGroup(const Entity &_entity, Group &_group);
+
+  /// \brief Remove an entity from a group. The entity must be a member
+  /// \param[in] _entity The entity
+  /// \param[in] _group The group
+  private: void LeaveGroup(const Entity &_entity, Group &_group);
+
+  /// \brief Move an entity's component to a slot of its pool, swapping it with
+  /// the slot's contents. Views that point at the moved components are updated
+  /// \param[in] _entity The entity
+  /// \param[in] _typeId The type of component to move
+  /// \param[in] _slot The slot to move the component to
+  private: void MoveToSlot(const Entity &_entity,
+               const ComponentTypeId &_typeId, const std::size_t _slot);
+
+  /// \brief Evict the least recently used views until the views fit in the
+  /// view memory budget
+  /// \param[in] _keep A view that should not be evicted, since it's about to
+  /// be used
+  private: void EnforceViewMemoryBudget(const BaseView *_keep);
+
+  /// \brief Implementation of Compact
+  /// \param[in] _first The view that should have priority over all other
+  /// views (nullptr to order views by use only)
+  /// \return true if component storage was reordered, false if a view is in
+  /// use
+  private: bool CompactStorage(const std::vector<ComponentTypeId> *_first);
+
+  /// \brief Add an entity to the name index, if it has a Name component
+  /// \param[in] _entity The entity
+  private: void IndexName(const Entity &_entity);
+
+  /// \brief Remove an entity from the name index, if it has a Name component
+  /// \param[in] _entity The entity
+  private: void UnindexName(const Entity &_entity);
+
+  /// \brief Get the names of a list of component types
+  /// \param[in] _compTypes The component types
+  /// \return A comma separated list of the component type names
+  private: std::string ComponentNames(
+               const std::vector<ComponentTypeId> &_compTypes) const;
+
   /// \brief Check if an entity has a component of a particular type
   /// \param[in] _entity The entity
   /// \param[in] _typeId The component type
@@ -54,12 +817,6 @@ class ECM
   private: bool HasComponent(const Entity &_entity,
                const ComponentTypeId &_typeId) const;
 
-  /// \brief Get the pointer to an entity's component of a particular type
-  /// \param[in] _entity The entity
-  /// \return The pointer to the component, if it exists. Otherwise, nullptr
-  private: template<typename ComponentTypeT>
-           ComponentTypeT *Component(const Entity &_entity) const;
-
   /// \brief See if an entity has a list of component types
   /// \param[in] _entity The entity
   /// \param[in] _compTypes The types of components
@@ -68,23 +825,41 @@ class ECM
   private: bool HasAllComponents(const Entity &_entity,
                const std::vector<ComponentTypeId> &_compTypes) const;
 
-  /// \brief A map of an Entity to its components
-  private: std::unordered_map<Entity,
-            std::vector<std::shared_ptr<BaseComponent>>> entityComponents;
-
-  /// \brief A map that keeps track of where each type of component is located
-  /// in the this->entityComponents vector. Since the this->entityComponents
-  /// vector is of type BaseComponent, we need to keep track of which component
-  /// type corresponds to a given index in the vector so that we can cast the
-  /// BaseComponent to this type if needed.
-  ///
-  /// The key of this map is the Entity, and the value is a map of the component
-  /// type to the corresponding index in the this->entityComponents vector
-  /// (a component of a particular type is only a key for the value map if a
-  /// component of this type exists in the this->entityComponents vector)
-  private: std::unordered_map<Entity,
-                              std::unordered_map<ComponentTypeId, std::size_t>>
-                                componentTypeIndex;
+  /// \brief Get the pool that stores components of a particular type
+  /// \param[in] _typeId The component type
+  /// \return The pool, or nullptr if no component of type _typeId has been
+  /// added to the ECM
+  private: ComponentPool *Pool(const ComponentTypeId &_typeId) const;
+
+  /// \brief Get the pool that stores components of a particular type,
+  /// creating it if needed
+  /// \return The pool
+  private: template<typename ComponentTypeT>
+           ComponentPool &PoolOf();
+
+  /// \brief Get the pool that stores components of a particular type,
+  /// creating it if needed
+  /// \param[in] _metadata The component type
+  /// \return The pool
+  private: ComponentPool &PoolOf(const ComponentMetadata &_metadata);
+
+  /// \brief Get a function that finds components in the ECM's pools, which
+  /// is used to add entities to views. The function returns storage addresses
+  /// (see ComponentPool::ComponentStorage), which don't change when the
+  /// buffers of double buffered components are swapped
+  /// \return The function
+  private: ComponentLookup Lookup() const;
+
+  /// \brief All of the entities in the ECM
+  private: std::unordered_set<Entity> entities;
+
+  /// \brief The entity to be returned by the next CreateEntity call
+  private: Entity nextEntity{0};
+
+  /// \brief The component pools, which store all of the component data. The
+  /// key of this map is the type of component stored in the pool
+  private: std::unordered_map<ComponentTypeId,
+            std::unique_ptr<ComponentPool>> pools;
 
   /// \brief Hash functor for std::vector<ComponentTypeId>
   private: struct VectorHasher
@@ -105,33 +880,214 @@ class ECM
   /// <position, velocity> is different than a <velocity, position> tuple)
   private: std::unordered_map<std::vector<ComponentTypeId>,
             std::unique_ptr<BaseView>, VectorHasher> views;
+
+  /// \brief Usage of every view that has been requested. Entries are kept
+  /// when a view is destroyed, so usage can be tracked across evictions
+  private: std::unordered_map<std::vector<ComponentTypeId>,
+            ViewUsageStats, VectorHasher> viewUsage;
+
+  /// \brief Incremented every time a view is requested, which orders view use
+  private: std::uint64_t viewUseSequence{0};
+
+  /// \brief The maximum number of bytes views should use (0 for no limit)
+  private: std::size_t viewMemoryBudget{0};
+
+  /// \brief The number of components added or removed since component
+  /// storage was last compacted
+  private: std::size_t layoutChanges{0};
+
+  /// \brief Whether component storage and views use huge pages
+  private: bool hugePages{false};
+
+  /// \brief All of the owning groups
+  private: std::vector<std::unique_ptr<Group>> groups;
+
+  /// \brief The group that owns each component type that belongs to a group
+  private: std::unordered_map<ComponentTypeId, Group *> groupOwners;
+
+  /// \brief The spatial index of each component type that has one
+  private: std::unordered_map<ComponentTypeId,
+            std::unique_ptr<SpatialIndex>> spatialIndexes;
+
+  /// \brief The entities with a Name component, by name
+  private: std::unordered_multimap<InternedString, Entity> nameIndex;
+
+  /// \brief The secondary indexes (see CreateIndex), in creation order
+  private: std::vector<std::unique_ptr<BaseComponentIndex>> componentIndexes;
+
+  /// \brief Separates writer phases from reader phases
+  private: mutable std::shared_mutex phaseMutex;
+
+  /// \brief Held by a writer phase that is waiting to start, which keeps new
+  /// reader phases from starting first
+  private: mutable std::mutex phaseGate;
 };
 
+ECM::ECM(const Entity _firstEntity)
+  : nextEntity(_firstEntity)
+{
+}
+
 Entity ECM::CreateEntity()
 {
-  Entity entityId = this->entityComponents.size();
-  this->entityComponents[entityId];
-  this->componentTypeIndex[entityId];
+  Entity entityId = this->nextEntity++;
+  this->entities.insert(entityId);
 
   return entityId;
 }
 
+EntityBatch ECM::ExtractEntities(const std::vector<Entity> &_entities)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::ExtractEntities");
+  EntityBatch batch;
+  for (const auto &entity : _entities)
+  {
+    if (this->entities.erase(entity))
+      batch.entities.push_back(entity);
+  }
+
+  // the entities leave their groups and views before their components are
+  // moved, since that may move other entities' components
+  for (const auto &entity : batch.entities)
+  {
+    for (auto &group : this->groups)
+    {
+      if (this->IsGroupMember(entity, *group))
+        this->LeaveGroup(entity, *group);
+    }
+  }
+  for (auto &[compTypes, view] : this->views)
+  {
+    for (const auto &entity : batch.entities)
+      view->RemoveEntity(entity);
+  }
+  for (auto &[typeId, index] : this->spatialIndexes)
+  {
+    for (const auto &entity : batch.entities)
+      index->grid.Remove(entity);
+  }
+  for (const auto &entity : batch.entities)
+    this->UnindexName(entity);
+  for (auto &index : this->componentIndexes)
+  {
+    for (const auto &entity : batch.entities)
+      index->Remove(entity);
+  }
+
+  for (auto &[typeId, pool] : this->pools)
+  {
+    ComponentColumn column(pool->Metadata());
+    pool->Extract(batch.entities, column);
+    if (!column.Size())
+      continue;
+    this->layoutChanges += column.Size();
+    batch.columns.push_back(std::move(column));
+  }
+  return batch;
+}
+
+void ECM::InsertEntities(EntityBatch &&_batch)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::InsertEntities");
+  this->entities.insert(_batch.entities.begin(), _batch.entities.end());
+  for (auto &column : _batch.columns)
+  {
+    this->layoutChanges += column.Size();
+    this->PoolOf(column.Metadata()).Insert(column);
+  }
+
+  for (auto &group : this->groups)
+  {
+    for (const auto &entity : _batch.entities)
+    {
+      if (this->HasAllComponents(entity, group->types))
+        this->JoinGroup(entity, *group);
+    }
+  }
+
+  for (auto &[typeId, index] : this->spatialIndexes)
+  {
+    auto pool = this->Pool(typeId);
+    for (const auto &entity : _batch.entities)
+    {
+      if (auto component = pool ? pool->Component(entity) : nullptr)
+        index->grid.Insert(entity, index->position(component));
+    }
+  }
+  for (const auto &entity : _batch.entities)
+    this->IndexName(entity);
+  for (auto &index : this->componentIndexes)
+  {
+    auto pool = this->Pool(index->TypeId());
+    for (const auto &entity : _batch.entities)
+    {
+      if (auto component = pool ? pool->Component(entity) : nullptr)
+        index->Insert(entity, component);
+    }
+  }
+
+  const auto lookup = this->Lookup();
+  for (auto &[compTypes, view] : this->views)
+  {
+    for (const auto &entity : _batch.entities)
+    {
+      if (!this->HasAllComponents(entity, compTypes))
+        continue;
+      if (view->Registered())
+        view->AddEntity(entity, lookup);
+      else
+        view->AddNewEntity(entity);
+    }
+  }
+
+  _batch.entities.clear();
+  _batch.columns.clear();
+}
+
 template<typename ComponentTypeT>
 void ECM::AddComponent(const Entity &_entity, const ComponentTypeT &_component)
 {
-  if (this->HasComponent(_entity, ComponentTypeT::typeId))
+  if (this->entities.find(_entity) == this->entities.end() ||
+      this->HasComponent(_entity, ComponentTypeT::typeId))
     return;
 
-  auto entityCompIter = this->entityComponents.find(_entity);
-  auto vectorIdx = entityCompIter->second.size();
-  entityCompIter->second.push_back(
-      std::make_shared<ComponentTypeT>(_component));
-  this->componentTypeIndex[_entity][ComponentTypeT::typeId] = vectorIdx;
+  this->PoolOf<ComponentTypeT>().Add(_entity, &_component);
+  this->layoutChanges++;
+  if (ComponentTypeT::typeId == Name::typeId)
+    this->IndexName(_entity);
+  for (auto &index : this->componentIndexes)
+  {
+    if (index->TypeId() == ComponentTypeT::typeId)
+      index->Insert(_entity, &_component);
+  }
+
+  auto ownerIter = this->groupOwners.find(ComponentTypeT::typeId);
+  if (ownerIter != this->groupOwners.end() &&
+      this->HasAllComponents(_entity, ownerIter->second->types))
+  {
+    this->JoinGroup(_entity, *ownerIter->second);
+  }
+
+  auto indexIter = this->spatialIndexes.find(ComponentTypeT::typeId);
+  if (indexIter != this->spatialIndexes.end())
+  {
+    indexIter->second->grid.Insert(_entity,
+        indexIter->second->position(&_component));
+  }
 
+  SIMPLE_ECM_TRACE_SCOPE("ECM::AddComponent view maintenance");
+  const auto lookup = this->Lookup();
   for (auto &[compTypes, view] : this->views)
   {
-    if (!view->HasEntity(_entity) && !view->HasNewEntity(_entity) &&
-        this->HasAllComponents(_entity, compTypes))
+    if (view->HasEntity(_entity) || view->HasNewEntity(_entity) ||
+        !this->HasAllComponents(_entity, compTypes))
+      continue;
+
+    // registered views are kept up to date, while other views catch up the
+    // next time they're used
+    if (view->Registered())
+      view->AddEntity(_entity, lookup);
+    else
       view->AddNewEntity(_entity);
   }
 }
@@ -143,25 +1099,29 @@ void ECM::RemoveComponent(const Entity &_entity)
   if (!this->HasComponent(_entity, ComponentTypeT::typeId))
     return;
 
-  // remove the component
-  //  - if the component to remove is the last component in the entity's vector
-  //    of components, simply pop off the last component from the vector
-  //  - if the component to remove is not the last component in the entity's
-  //    vector of components, swap it with the last component in the vector and
-  //    then pop off the last component in the vector
-  const auto removalCompIdx =
-    this->componentTypeIndex[_entity][ComponentTypeT::typeId];
-  if (removalCompIdx != (this->entityComponents[_entity].size() - 1))
+  auto ownerIter = this->groupOwners.find(ComponentTypeT::typeId);
+  if (ownerIter != this->groupOwners.end() &&
+      this->IsGroupMember(_entity, *ownerIter->second))
+  {
+    this->LeaveGroup(_entity, *ownerIter->second);
+  }
+
+  if (ComponentTypeT::typeId == Name::typeId)
+    this->UnindexName(_entity);
+  for (auto &index : this->componentIndexes)
   {
-    const auto lastBaseComp = this->entityComponents[_entity].back();
-    this->componentTypeIndex[_entity][lastBaseComp->DerivedTypeId()] =
-      removalCompIdx;
-    this->entityComponents[_entity][removalCompIdx] = lastBaseComp;
+    if (index->TypeId() == ComponentTypeT::typeId)
+      index->Remove(_entity);
   }
-  this->entityComponents[_entity].pop_back();
-  this->componentTypeIndex[_entity].erase(ComponentTypeT::typeId);
+  this->Pool(ComponentTypeT::typeId)->Remove(_entity);
+  this->layoutChanges++;
+
+  auto indexIter = this->spatialIndexes.find(ComponentTypeT::typeId);
+  if (indexIter != this->spatialIndexes.end())
+    indexIter->second->grid.Remove(_entity);
 
   // remove the entity from the views that have this component
+  SIMPLE_ECM_TRACE_SCOPE("ECM::RemoveComponent view maintenance");
   for (auto &[compTypes, view] : this->views)
   {
     if (view->HasComponent(ComponentTypeT::typeId))
@@ -173,77 +1133,1305 @@ template<typename ...ComponentTypeTs>
 void ECM::Each(
     std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
 {
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Each");
+  if (auto group = this->FindGroup<ComponentTypeTs...>())
+  {
+    this->EachInGroup<ComponentTypeTs...>(_f, *group,
+        std::index_sequence_for<ComponentTypeTs...>());
+    return;
+  }
+
   auto view = this->FindView<ComponentTypeTs...>();
+  ViewPin pin(view);
 
-  for (const auto &entity : view->Entities())
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Each iteration");
+  if (view->Packed())
   {
-    if (!std::apply(_f, view->EntityComponentData(entity)))
-      break;
+    this->EachPackedInView<ComponentTypeTs...>(_f, *view,
+        std::index_sequence_for<ComponentTypeTs...>());
+    return;
   }
+  this->EachInView<ComponentTypeTs...>(_f, *view,
+      std::index_sequence_for<ComponentTypeTs...>());
 }
 
-std::size_t ECM::ViewCount() const
+template<typename ...ComponentTypeTs>
+bool ECM::EachBudgeted(EachCursor &_cursor, const EachBudget &_budget,
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
 {
-  return this->views.size();
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachBudgeted");
+  auto view = this->FindView<ComponentTypeTs...>();
+  ViewPin pin(view);
+  return this->EachBudgetedInView<ComponentTypeTs...>(_cursor, _budget, _f,
+      *view, std::index_sequence_for<ComponentTypeTs...>());
 }
 
 template<typename ...ComponentTypeTs>
-View<ComponentTypeTs...> *ECM::FindView()
+ViewRange<ComponentTypeTs...> ECM::Query()
 {
-  std::vector<ComponentTypeId> viewKey {ComponentTypeTs::typeId...};
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Query");
+  auto view = this->FindView<ComponentTypeTs...>();
+  return ViewRange<ComponentTypeTs...>(view,
+      this->ViewOffsets<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachChunk(std::function<bool(Span<const Entity> _entities,
+                                       Span<ComponentTypeTs>...)> _f)
+{
+  static_assert(!(... || IsTagComponent<ComponentTypeTs>::value),
+      "EachChunk can't iterate over tags");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachChunk");
+  if (auto group = this->FindGroup<ComponentTypeTs...>())
+  {
+    this->EachChunkInGroup<ComponentTypeTs...>(_f, *group,
+        std::index_sequence_for<ComponentTypeTs...>());
+    return;
+  }
+
+  auto view = this->FindView<ComponentTypeTs...>();
+  ViewPin pin(view);
+  this->EachChunkInView<ComponentTypeTs...>(_f, *view,
+      std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachTransient(
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f) const
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachTransient needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachTransient");
+
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> pools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  for (const auto pool : pools)
+  {
+    // no entity can have all of the components
+    if (!pool)
+      return;
+  }
+
+  this->EachTransientInPools<ComponentTypeTs...>(_f, pools, {},
+      std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+void ECM::EachTransientInPools(
+    const std::function<bool(const Entity &_entity, ComponentTypeTs*...)> &_f,
+    const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> &_pools,
+    const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> &_offsets,
+    std::index_sequence<Indices...>) const
+{
+  // drive the query with the smallest pool, since every entity that matches
+  // the query is in it
+  std::size_t driver = 0;
+  for (std::size_t i = 1; i < _pools.size(); ++i)
+  {
+    if (_pools[i]->Size() < _pools[driver]->Size())
+      driver = i;
+  }
+  const auto &driverPool = *_pools[driver];
+
+  for (std::size_t slot = 0; slot < driverPool.SlotCount(); ++slot)
+  {
+    const auto entity = driverPool.SlotEntity(slot);
+    if (entity == kNullEntity)
+      continue;
+
+    const std::array<void *, sizeof...(ComponentTypeTs)> data{
+      (Indices == driver ? driverPool.SlotData(slot) :
+                           _pools[Indices]->Component(entity))...};
+    bool hasAll = true;
+    for (const auto component : data)
+      hasAll = hasAll && component;
+    if (!hasAll)
+      continue;
+
+    if (!_f(entity, OffsetPointer(static_cast<ComponentTypeTs*>(data[Indices]),
+            _offsets[Indices])...))
+      break;
+  }
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachCommitted(std::function<bool(const Entity &_entity,
+                        const ComponentTypeTs*...)> _f) const
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachCommitted needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachCommitted");
+
+  // groups are always up to date
+  if (auto group = this->FindGroup<ComponentTypeTs...>())
+  {
+    this->EachInGroup<ComponentTypeTs...>(_f, *group,
+        std::index_sequence_for<ComponentTypeTs...>());
+    return;
+  }
+
+  // a view can only be used if nothing has to be added to it, since it must
+  // not change
+  auto iter = this->views.find({ComponentTypeTs::typeId...});
+  if (iter != this->views.end() && !iter->second->HasNewEntities())
+  {
+    this->EachInView<ComponentTypeTs...>(_f,
+        static_cast<const View<ComponentTypeTs...> &>(*iter->second),
+        std::index_sequence_for<ComponentTypeTs...>());
+    return;
+  }
+
+  SIMPLE_ECM_TRACE_COUNT("uncommitted view");
+  this->EachTransient<ComponentTypeTs...>(
+      std::function<bool(const Entity &, ComponentTypeTs*...)>(
+        [&_f](const Entity &_entity, ComponentTypeTs*... _components)
+        {
+          return _f(_entity, _components...);
+        }));
+}
+
+ECM::WritePhase::WritePhase(ECM &_ecm)
+  : ecm(_ecm)
+{
+  // hold the gate while waiting, so that readers that arrive in the meantime
+  // wait for this phase instead of keeping it from ever starting
+  std::lock_guard<std::mutex> gate(this->ecm.phaseGate);
+  this->lock = std::unique_lock<std::shared_mutex>(this->ecm.phaseMutex);
+}
+
+ECM::WritePhase::~WritePhase()
+{
+  this->ecm.Commit();
+}
+
+ECM::WritePhase ECM::BeginWrites()
+{
+  return WritePhase(*this);
+}
+
+std::shared_lock<std::shared_mutex> ECM::BeginReads() const
+{
+  std::lock_guard<std::mutex> gate(this->phaseGate);
+  return std::shared_lock<std::shared_mutex>(this->phaseMutex);
+}
+
+void ECM::Commit()
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Commit");
+  bool added = false;
+  const auto lookup = this->Lookup();
+  for (auto &[compTypes, view] : this->views)
+  {
+    if (!view->HasNewEntities())
+      continue;
+    for (const auto &entity : view->NewEntities())
+      view->AddEntity(entity, lookup);
+    view->RemoveNewEntities();
+    added = true;
+  }
+
+  if (added)
+    this->EnforceViewMemoryBudget(nullptr);
+}
+
+template<typename ComponentTypeT>
+bool ECM::SetDoubleBuffered(const bool _doubleBuffered)
+{
+  for (const auto &[compTypes, view] : this->views)
+  {
+    if (view->HasComponent(ComponentTypeT::typeId) && view->Pinned())
+      return false;
+  }
+
+  auto &pool = this->PoolOf<ComponentTypeT>();
+  if (pool.DoubleBuffered() == _doubleBuffered)
+    return true;
+
+  // the components are moved to new pages
+  SIMPLE_ECM_TRACE_SCOPE("ECM::SetDoubleBuffered");
+  pool.SetDoubleBuffered(_doubleBuffered);
+  const auto lookup = this->Lookup();
+  for (auto &[compTypes, view] : this->views)
+  {
+    if (view->HasComponent(ComponentTypeT::typeId))
+      view->Relink(lookup);
+  }
+  return true;
+}
+
+void ECM::SwapBuffers()
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::SwapBuffers");
+  for (auto &[typeId, pool] : this->pools)
+    pool->SwapBuffers();
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachBuffered(
+    typename BufferedCallback<ComponentTypeTs...>::Type _f,
+    const std::size_t _threads)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachBuffered");
+  auto view = this->FindView<ComponentTypeTs...>();
+  ViewPin pin(view);
+  const auto current = this->ViewOffsets<ComponentTypeTs...>(false);
+  const auto next = this->ViewOffsets<ComponentTypeTs...>(true);
+
+  // every thread gets a contiguous share of the rows. The calling thread takes
+  // the first share
+  const auto numRows = view->EntityCount();
+  const auto numThreads =
+    std::max<std::size_t>(1, std::min(_threads, numRows));
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < numThreads; ++t)
+  {
+    workers.emplace_back([this, &_f, view, &current, &next, numRows,
+        numThreads, t]()
+        {
+          this->EachBufferedInRows<ComponentTypeTs...>(_f, *view, current,
+              next, numRows * t / numThreads,
+              numRows * (t + 1) / numThreads,
+              std::index_sequence_for<ComponentTypeTs...>());
+        });
+  }
+  this->EachBufferedInRows<ComponentTypeTs...>(_f, *view, current, next, 0,
+      numRows / numThreads, std::index_sequence_for<ComponentTypeTs...>());
+  for (auto &worker : workers)
+    worker.join();
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+void ECM::EachBufferedInRows(
+    const typename BufferedCallback<ComponentTypeTs...>::Type &_f,
+    const View<ComponentTypeTs...> &_view,
+    const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> &_current,
+    const std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> &_next,
+    const std::size_t _begin, const std::size_t _end,
+    std::index_sequence<Indices...>) const
+{
+  for (auto row = _begin; row < _end; ++row)
+  {
+    const auto &data = _view.Row(row);
+    if (!_f(std::get<0>(data),
+          OffsetPointer(static_cast<const ComponentTypeTs*>(
+              std::get<Indices + 1>(data)), _current[Indices])...,
+          OffsetPointer(std::get<Indices + 1>(data), _next[Indices])...))
+      return;
+  }
+}
+
+template<typename ...ComponentTypeTs>
+std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> ECM::ViewOffsets(
+    const bool _next) const
+{
+  std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)> offsets{};
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> viewPools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  for (std::size_t i = 0; i < viewPools.size(); ++i)
+  {
+    if (viewPools[i])
+    {
+      offsets[i] =
+        _next ? viewPools[i]->NextOffset() : viewPools[i]->CurrentOffset();
+    }
+  }
+  return offsets;
+}
+
+template<typename ...ComponentTypeTs, typename FunctionT,
+         std::size_t ...Indices>
+void ECM::EachInView(const FunctionT &_f,
+    const View<ComponentTypeTs...> &_view,
+    std::index_sequence<Indices...>) const
+{
+  const auto offsets = this->ViewOffsets<ComponentTypeTs...>();
+  if (std::all_of(offsets.begin(), offsets.end(),
+        [](const std::ptrdiff_t _offset)
+        {
+          return _offset == 0;
+        }))
+  {
+    for (const auto &row : _view.Rows())
+    {
+      if (!std::apply(_f, row))
+        return;
+    }
+    return;
+  }
+
+  // some of the components are double buffered, and the view points at their
+  // storage addresses instead of their current values
+  for (const auto &row : _view.Rows())
+  {
+    if (!_f(std::get<0>(row),
+          OffsetPointer(std::get<Indices + 1>(row), offsets[Indices])...))
+      return;
+  }
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+void ECM::EachPackedInView(
+    const std::function<bool(const Entity &_entity, ComponentTypeTs*...)> &_f,
+    View<ComponentTypeTs...> &_view, std::index_sequence<Indices...>)
+{
+  const auto offsets = this->ViewOffsets<ComponentTypeTs...>();
+  auto &copies = _view.Pack(offsets);
+
+  // only the rows that the callback got to have to be written back
+  std::size_t row = 0;
+  for (; row < copies.size(); ++row)
+  {
+    if (!_f(std::get<0>(_view.Row(row)), &std::get<Indices>(copies[row])...))
+    {
+      ++row;
+      break;
+    }
+  }
+  _view.Unpack(offsets, row);
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+bool ECM::EachBudgetedInView(EachCursor &_cursor, const EachBudget &_budget,
+    const std::function<bool(const Entity &_entity, ComponentTypeTs*...)> &_f,
+    const View<ComponentTypeTs...> &_view, std::index_sequence<Indices...>)
+{
+  const std::vector<ComponentTypeId> types{ComponentTypeTs::typeId...};
+  if (_cursor.types != types)
+  {
+    _cursor.Reset();
+    _cursor.types = types;
+  }
+
+  // a new pass goes through the entities that are in the view now
+  const auto start = std::chrono::steady_clock::now();
+  if (!_cursor.inPass)
+  {
+    _cursor.remaining.clear();
+    _cursor.remaining.reserve(_view.EntityCount());
+    for (auto row = _view.EntityCount(); row-- > 0;)
+      _cursor.remaining.emplace_back(std::get<0>(_view.Row(row)), row);
+    _cursor.inPass = true;
+  }
+
+  // reading the clock for every entity would cost about as much as a cheap
+  // callback, so the time is checked every few entities
+  constexpr std::size_t kTimeCheckInterval{16};
+  const auto offsets = this->ViewOffsets<ComponentTypeTs...>();
+  std::size_t visited = 0;
+  while (!_cursor.remaining.empty())
+  {
+    if (_budget.maxEntities > 0 && visited >= _budget.maxEntities)
+      return false;
+    if (_budget.maxTime.count() > 0 && visited > 0 &&
+        visited % kTimeCheckInterval == 0 &&
+        std::chrono::steady_clock::now() - start >= _budget.maxTime)
+    {
+      return false;
+    }
+
+    const auto [entity, rowIndex] = _cursor.remaining.back();
+    _cursor.remaining.pop_back();
+
+    // the entity may have moved to another row, or lost one of the
+    // components, since the pass started
+    auto row = rowIndex < _view.EntityCount() ? &_view.Row(rowIndex) : nullptr;
+    if (!row || std::get<0>(*row) != entity)
+      row = _view.FindRow(entity);
+    if (!row)
+      continue;
+
+    visited++;
+    if (!_f(entity,
+          OffsetPointer(std::get<Indices + 1>(*row), offsets[Indices])...))
+      break;
+  }
+
+  if (!_cursor.remaining.empty())
+    return false;
+  _cursor.inPass = false;
+  _cursor.passes++;
+  return true;
+}
+
+template<typename ComponentTypeT>
+bool ECM::CreateSpatialIndex(const int _cellSize)
+{
+  auto &index = this->spatialIndexes[ComponentTypeT::typeId];
+  if (index)
+    return false;
+
+  SIMPLE_ECM_TRACE_SCOPE("ECM::CreateSpatialIndex");
+  index = std::make_unique<SpatialIndex>(SpatialIndex{SpatialGrid(_cellSize),
+      [](const void *_component)
+      {
+        return SpatialPosition(
+            *static_cast<const ComponentTypeT *>(_component));
+      }});
+
+  // index the components that already exist
+  if (auto pool = this->Pool(ComponentTypeT::typeId))
+  {
+    for (std::size_t slot = 0; slot < pool->SlotCount(); ++slot)
+    {
+      const auto entity = pool->SlotEntity(slot);
+      if (entity != kNullEntity)
+        index->grid.Insert(entity, index->position(pool->SlotData(slot)));
+    }
+  }
+  return true;
+}
+
+template<typename ComponentTypeT>
+bool ECM::UpdateSpatialIndex(const Entity &_entity)
+{
+  auto iter = this->spatialIndexes.find(ComponentTypeT::typeId);
+  if (iter == this->spatialIndexes.end())
+    return false;
+
+  const auto component = static_cast<const ComponentTypeT *>(
+      this->Pool(ComponentTypeT::typeId)->Component(_entity));
+  return component &&
+    iter->second->grid.Update(_entity, SpatialPosition(*component));
+}
+
+template<typename ComponentTypeT>
+std::size_t ECM::UpdateSpatialIndex()
+{
+  auto iter = this->spatialIndexes.find(ComponentTypeT::typeId);
+  if (iter == this->spatialIndexes.end())
+    return 0;
+
+  SIMPLE_ECM_TRACE_SCOPE("ECM::UpdateSpatialIndex");
+  auto &grid = iter->second->grid;
+  const auto &pool = *this->Pool(ComponentTypeT::typeId);
+  std::size_t moved = 0;
+  for (std::size_t slot = 0; slot < pool.SlotCount(); ++slot)
+  {
+    const auto entity = pool.SlotEntity(slot);
+    if (entity != kNullEntity && grid.Update(entity, SpatialPosition(
+            *static_cast<const ComponentTypeT *>(pool.SlotData(slot)))))
+    {
+      moved++;
+    }
+  }
+  return moved;
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachInBox(const Vector3i &_min, const Vector3i &_max,
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachInBox needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachInBox");
+  this->EachInRegion<ComponentTypeTs...>(_min, _max,
+      [&_min, &_max](const Vector3i &_position)
+      {
+        return _position.x >= _min.x && _position.x <= _max.x &&
+          _position.y >= _min.y && _position.y <= _max.y &&
+          _position.z >= _min.z && _position.z <= _max.z;
+      }, _f, std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::EachInRadius(const Vector3i &_center, const int _radius,
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachInRadius needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachInRadius");
+  const Vector3i min{_center.x - _radius, _center.y - _radius,
+    _center.z - _radius};
+  const Vector3i max{_center.x + _radius, _center.y + _radius,
+    _center.z + _radius};
+  const auto radiusSquared = static_cast<std::int64_t>(_radius) * _radius;
+  this->EachInRegion<ComponentTypeTs...>(min, max,
+      [&_center, radiusSquared](const Vector3i &_position)
+      {
+        const std::int64_t dx = _position.x - _center.x;
+        const std::int64_t dy = _position.y - _center.y;
+        const std::int64_t dz = _position.z - _center.z;
+        return dx * dx + dy * dy + dz * dz <= radiusSquared;
+      }, _f, std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs, typename ContainsT,
+         std::size_t ...Indices>
+void ECM::EachInRegion(const Vector3i &_min, const Vector3i &_max,
+    const ContainsT &_contains,
+    const std::function<bool(const Entity &_entity, ComponentTypeTs*...)> &_f,
+    std::index_sequence<Indices...>)
+{
+  using PositionTypeT =
+    std::tuple_element_t<0, std::tuple<ComponentTypeTs...>>;
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> pools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  for (const auto pool : pools)
+  {
+    // no entity can have all of the components
+    if (!pool)
+      return;
+  }
+
+  const auto visit = [&pools, &_contains, &_f](const Entity &_entity)
+    {
+      const std::array<void *, sizeof...(ComponentTypeTs)> data{
+        pools[Indices]->Component(_entity)...};
+      for (const auto component : data)
+      {
+        if (!component)
+          return true;
+      }
+      if (!_contains(SpatialPosition(
+              *static_cast<const PositionTypeT *>(data[0]))))
+        return true;
+      return _f(_entity, static_cast<ComponentTypeTs*>(data[Indices])...);
+    };
+
+  auto iter = this->spatialIndexes.find(PositionTypeT::typeId);
+  if (iter != this->spatialIndexes.end())
+  {
+    iter->second->grid.EachCandidate(_min, _max, visit);
+    return;
+  }
+
+  // without an index, every entity with a position is a candidate
+  SIMPLE_ECM_TRACE_COUNT("unindexed spatial query");
+  const auto &pool = *pools[0];
+  for (std::size_t slot = 0; slot < pool.SlotCount(); ++slot)
+  {
+    const auto entity = pool.SlotEntity(slot);
+    if (entity != kNullEntity && !visit(entity))
+      return;
+  }
+}
+
+template<typename IndexT>
+IndexHandle<IndexT> ECM::CreateIndex(typename IndexT::Projection _projection)
+{
+  using ComponentTypeT = typename IndexT::Component;
+  SIMPLE_ECM_TRACE_SCOPE("ECM::CreateIndex");
+  auto index = std::make_unique<IndexT>(std::move(_projection));
+
+  // index the components that already exist
+  if (auto pool = this->Pool(ComponentTypeT::typeId))
+  {
+    for (std::size_t slot = 0; slot < pool->SlotCount(); ++slot)
+    {
+      const auto entity = pool->SlotEntity(slot);
+      if (entity != kNullEntity)
+        index->Insert(entity, pool->SlotData(slot));
+    }
+  }
+
+  this->componentIndexes.push_back(std::move(index));
+  return IndexHandle<IndexT>{this->componentIndexes.size() - 1};
+}
+
+template<typename ComponentTypeT>
+bool ECM::MarkModified(const Entity &_entity)
+{
+  auto pool = this->Pool(ComponentTypeT::typeId);
+  auto component = pool ? pool->Component(_entity) : nullptr;
+  if (!component)
+    return false;
+
+  for (auto &index : this->componentIndexes)
+  {
+    if (index->TypeId() == ComponentTypeT::typeId)
+      index->Update(_entity, component);
+  }
+  auto spatialIter = this->spatialIndexes.find(ComponentTypeT::typeId);
+  if (spatialIter != this->spatialIndexes.end())
+  {
+    spatialIter->second->grid.Update(_entity,
+        spatialIter->second->position(component));
+  }
+  return true;
+}
+
+template<typename ...ComponentTypeTs, typename IndexT>
+void ECM::EachWhere(const IndexHandle<IndexT> &_index,
+    const typename IndexT::Key &_key,
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachWhere needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachWhere");
+  const auto &index =
+    static_cast<const IndexT &>(*this->componentIndexes[_index.id]);
+  this->EachIndexed<ComponentTypeTs...>(
+      [&index, &_key](const auto &_visit)
+      {
+        index.EachEqual(_key, _visit);
+      }, _f, std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs, typename IndexT>
+void ECM::EachInRange(const IndexHandle<IndexT> &_index,
+    const typename IndexT::Key &_min, const typename IndexT::Key &_max,
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "EachInRange needs at least one component type");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachInRange");
+  const auto &index =
+    static_cast<const IndexT &>(*this->componentIndexes[_index.id]);
+  this->EachIndexed<ComponentTypeTs...>(
+      [&index, &_min, &_max](const auto &_visit)
+      {
+        index.EachInRange(_min, _max, _visit);
+      }, _f, std::index_sequence_for<ComponentTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs, typename EachEntityT,
+         std::size_t ...Indices>
+void ECM::EachIndexed(const EachEntityT &_eachEntity,
+    const std::function<bool(const Entity &_entity, ComponentTypeTs*...)> &_f,
+    std::index_sequence<Indices...>)
+{
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> pools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  for (const auto pool : pools)
+  {
+    // no entity can have all of the components
+    if (!pool)
+      return;
+  }
+
+  _eachEntity([&pools, &_f](const Entity &_entity)
+      {
+        const std::array<void *, sizeof...(ComponentTypeTs)> data{
+          pools[Indices]->Component(_entity)...};
+        for (const auto component : data)
+        {
+          if (!component)
+            return true;
+        }
+        return _f(_entity, static_cast<ComponentTypeTs*>(data[Indices])...);
+      });
+}
+
+Entity ECM::EntityByName(const std::string &_name) const
+{
+  // names that were never interned can't be in the index, and looking them up
+  // shouldn't add them to the table
+  InternedString name;
+  if (!InternedString::Find(_name, name))
+    return kNullEntity;
+
+  auto iter = this->nameIndex.find(name);
+  if (iter == this->nameIndex.end())
+    return kNullEntity;
+  return iter->second;
+}
+
+bool ECM::SetName(const Entity &_entity, const InternedString &_name)
+{
+  auto pool = this->Pool(Name::typeId);
+  auto component = pool ? static_cast<Name *>(pool->Component(_entity)) :
+    nullptr;
+  if (!component)
+    return false;
+
+  this->UnindexName(_entity);
+  component->name = _name;
+  this->IndexName(_entity);
+  this->MarkModified<Name>(_entity);
+  return true;
+}
+
+std::size_t ECM::ViewCount() const
+{
+  return this->views.size();
+}
+
+template<typename ...ComponentTypeTs>
+bool ECM::CreateGroup()
+{
+  static_assert(sizeof...(ComponentTypeTs) > 0,
+      "A group needs at least one component type");
+  std::vector<ComponentTypeId> types{ComponentTypeTs::typeId...};
+  std::sort(types.begin(), types.end());
+  if (std::adjacent_find(types.begin(), types.end()) != types.end() ||
+      (... || IsTagComponent<ComponentTypeTs>::value))
+    return false;
+  for (const auto &typeId : types)
+  {
+    if (this->groupOwners.find(typeId) != this->groupOwners.end())
+      return false;
+  }
+
+  SIMPLE_ECM_TRACE_SCOPE("ECM::CreateGroup");
+  this->groups.push_back(std::make_unique<Group>());
+  auto &group = *this->groups.back();
+  group.types = types;
+  for (const auto &typeId : types)
+    this->groupOwners[typeId] = &group;
+
+  // the entities that already have all of the component types join the group.
+  // They're found by going through the smallest pool
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> groupPools{
+    &this->PoolOf<ComponentTypeTs>()...};
+  const auto driver = *std::min_element(groupPools.begin(), groupPools.end(),
+      [](const ComponentPool *_a, const ComponentPool *_b)
+      {
+        return _a->Size() < _b->Size();
+      });
+  std::vector<Entity> members;
+  for (std::size_t slot = 0; slot < driver->SlotCount(); ++slot)
+  {
+    const auto entity = driver->SlotEntity(slot);
+    if (entity != kNullEntity && this->HasAllComponents(entity, types))
+      members.push_back(entity);
+  }
+  for (const auto &entity : members)
+    this->JoinGroup(entity, group);
+
+  return true;
+}
+
+EcmMemoryStats ECM::MemoryStats() const
+{
+  EcmMemoryStats stats;
+  stats.entities = this->entities.size();
+  stats.entityBytes = UnorderedMemoryBytes(this->entities);
+
+  for (const auto &[typeId, pool] : this->pools)
+    stats.components.push_back(pool->MemoryStats());
+  std::sort(stats.components.begin(), stats.components.end(),
+      [](const ComponentMemoryStats &_a, const ComponentMemoryStats &_b)
+      {
+        return _a.typeId < _b.typeId;
+      });
+
+  stats.viewIndexBytes = UnorderedMemoryBytes(this->views);
+  for (const auto &[compTypes, view] : this->views)
+  {
+    auto viewStats = view->MemoryStats();
+    viewStats.componentTypes = compTypes;
+    viewStats.name = this->ComponentNames(compTypes);
+    stats.viewIndexBytes += VectorMemoryBytes(compTypes);
+    stats.views.push_back(viewStats);
+  }
+
+  for (const auto &[typeId, index] : this->spatialIndexes)
+  {
+    IndexMemoryStats indexStats;
+    indexStats.name = "Spatial grid of " + this->ComponentNames({typeId});
+    indexStats.entries = index->grid.Size();
+    indexStats.bytes = sizeof(SpatialIndex) + index->grid.MemoryBytes();
+    stats.indexes.push_back(indexStats);
+  }
+
+  for (const auto &index : this->componentIndexes)
+  {
+    IndexMemoryStats indexStats;
+    indexStats.name = "Index of " + this->ComponentNames({index->TypeId()});
+    indexStats.entries = index->Size();
+    indexStats.bytes = index->MemoryBytes();
+    stats.indexes.push_back(indexStats);
+  }
+
+  if (!this->nameIndex.empty())
+  {
+    IndexMemoryStats indexStats;
+    indexStats.name = "Name index";
+    indexStats.entries = this->nameIndex.size();
+    indexStats.bytes = UnorderedMemoryBytes(this->nameIndex);
+    stats.indexes.push_back(indexStats);
+  }
+
+  return stats;
+}
+
+bool ECM::Compact()
+{
+  return this->CompactStorage(nullptr);
+}
+
+template<typename ...ComponentTypeTs>
+bool ECM::Compact()
+{
+  this->FindView<ComponentTypeTs...>();
+  const std::vector<ComponentTypeId> viewKey{ComponentTypeTs::typeId...};
+  return this->CompactStorage(&viewKey);
+}
+
+double ECM::LayoutChurn() const
+{
+  std::size_t numComponents = 0;
+  for (const auto &[typeId, pool] : this->pools)
+    numComponents += pool->Size();
+  if (!numComponents)
+    return this->layoutChanges ? 1.0 : 0.0;
+  return static_cast<double>(this->layoutChanges) / numComponents;
+}
+
+bool ECM::CompactIfNeeded(const double _minChurn)
+{
+  if (!this->layoutChanges || this->LayoutChurn() < _minChurn)
+    return false;
+  return this->Compact();
+}
+
+bool ECM::SetHugePages(const bool _hugePages)
+{
+  if (!kHugePagesSupported && _hugePages)
+    return false;
+  for (const auto &[compTypes, view] : this->views)
+  {
+    if (view->Pinned())
+      return false;
+  }
+  if (this->hugePages == _hugePages)
+    return true;
+
+  // the components are moved to new pages
+  SIMPLE_ECM_TRACE_SCOPE("ECM::SetHugePages");
+  this->hugePages = _hugePages;
+  for (auto &[typeId, pool] : this->pools)
+    pool->SetHugePages(_hugePages);
+  const auto lookup = this->Lookup();
+  for (auto &[compTypes, view] : this->views)
+  {
+    view->SetHugePages(_hugePages);
+    view->Relink(lookup);
+  }
+  return true;
+}
+
+bool ECM::HugePages() const
+{
+  return this->hugePages;
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::RegisterView()
+{
+  this->FindView<ComponentTypeTs...>()->SetRegistered(true);
+}
+
+template<typename ...ComponentTypeTs>
+void ECM::SetViewPacked(const bool _packed)
+{
+  this->FindView<ComponentTypeTs...>()->SetPacked(_packed);
+}
+
+template<typename ...ComponentTypeTs>
+bool ECM::DestroyView()
+{
+  auto iter = this->views.find({ComponentTypeTs::typeId...});
+  if (iter == this->views.end() || iter->second->Pinned())
+    return false;
+
+  this->views.erase(iter);
+  return true;
+}
+
+std::size_t ECM::DestroyViews()
+{
+  std::size_t numDestroyed = 0;
+  for (auto iter = this->views.begin(); iter != this->views.end();)
+  {
+    if (iter->second->Pinned())
+    {
+      ++iter;
+      continue;
+    }
+    iter = this->views.erase(iter);
+    numDestroyed++;
+  }
+  return numDestroyed;
+}
+
+void ECM::SetViewMemoryBudget(const std::size_t _bytes)
+{
+  this->viewMemoryBudget = _bytes;
+  this->EnforceViewMemoryBudget(nullptr);
+}
+
+std::size_t ECM::ViewMemoryBudget() const
+{
+  return this->viewMemoryBudget;
+}
+
+std::vector<ViewUsageStats> ECM::ViewStats() const
+{
+  std::vector<ViewUsageStats> stats;
+  for (const auto &[compTypes, usage] : this->viewUsage)
+  {
+    auto viewStats = usage;
+    viewStats.componentTypes = compTypes;
+    viewStats.name = this->ComponentNames(compTypes);
+
+    auto viewIter = this->views.find(compTypes);
+    viewStats.alive = viewIter != this->views.end();
+    if (viewStats.alive)
+    {
+      const auto memoryStats = viewIter->second->MemoryStats();
+      viewStats.rows = memoryStats.rows;
+      viewStats.bytes = memoryStats.TotalBytes();
+    }
+    stats.push_back(viewStats);
+  }
+
+  std::sort(stats.begin(), stats.end(),
+      [](const ViewUsageStats &_a, const ViewUsageStats &_b)
+      {
+        return _a.useCount > _b.useCount;
+      });
+  return stats;
+}
+
+template<typename ...ComponentTypeTs>
+ECM::Group *ECM::FindGroup() const
+{
+  if (this->groupOwners.empty())
+    return nullptr;
+
+  const std::array<ComponentTypeId, sizeof...(ComponentTypeTs)> types{
+    ComponentTypeTs::typeId...};
+  auto iter = this->groupOwners.find(types[0]);
+  if (iter == this->groupOwners.end() ||
+      iter->second->types.size() != types.size())
+    return nullptr;
+
+  for (const auto &typeId : types)
+  {
+    auto ownerIter = this->groupOwners.find(typeId);
+    if (ownerIter == this->groupOwners.end() ||
+        ownerIter->second != iter->second)
+      return nullptr;
+  }
+  return iter->second;
+}
+
+template<typename ...ComponentTypeTs, typename FunctionT,
+         std::size_t ...Indices>
+void ECM::EachInGroup(const FunctionT &_f, const Group &_group,
+    std::index_sequence<Indices...>) const
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Each group iteration");
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> groupPools{
+    this->Pool(ComponentTypeTs::typeId)...};
+
+  // members are stored in the same slots of every pool, so the components of
+  // a page of members can be walked through by index
+  for (std::size_t pageStart = 0; pageStart < _group.size;
+       pageStart += ComponentPool::kPageSize)
+  {
+    const auto pageEnd =
+      std::min(_group.size, pageStart + ComponentPool::kPageSize);
+    const std::tuple<ComponentTypeTs*...> page{static_cast<ComponentTypeTs*>(
+        groupPools[Indices]->SlotData(pageStart))...};
+    for (std::size_t slot = pageStart; slot < pageEnd; ++slot)
+    {
+      const auto offset = slot - pageStart;
+      if (!_f(groupPools[0]->SlotEntity(slot),
+            (std::get<Indices>(page) + offset)...))
+        return;
+    }
+  }
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+void ECM::EachChunkInGroup(
+    const std::function<bool(Span<const Entity> _entities,
+                             Span<ComponentTypeTs>...)> &_f,
+    const Group &_group, std::index_sequence<Indices...>)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachChunk group iteration");
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> groupPools{
+    this->Pool(ComponentTypeTs::typeId)...};
+
+  // every page of members is a block
+  for (std::size_t pageStart = 0; pageStart < _group.size;
+       pageStart += ComponentPool::kPageSize)
+  {
+    const auto pageSize =
+      std::min(_group.size - pageStart, ComponentPool::kPageSize);
+    if (!_f(Span<const Entity>(groupPools[0]->SlotEntities() + pageStart,
+            pageSize), Span<ComponentTypeTs>(static_cast<ComponentTypeTs*>(
+                groupPools[Indices]->SlotData(pageStart)), pageSize)...))
+      return;
+  }
+}
+
+template<typename ...ComponentTypeTs, std::size_t ...Indices>
+void ECM::EachChunkInView(
+    const std::function<bool(Span<const Entity> _entities,
+                             Span<ComponentTypeTs>...)> &_f,
+    const View<ComponentTypeTs...> &_view, std::index_sequence<Indices...>)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::EachChunk view iteration");
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> viewPools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  const auto offsets = this->ViewOffsets<ComponentTypeTs...>();
+  std::vector<Entity> blockEntities(
+      std::min(_view.EntityCount(), ComponentPool::kPageSize));
+
+  std::size_t row = 0;
+  while (row < _view.EntityCount())
+  {
+    // extend the block while every component of the next row directly
+    // follows the same component of the previous row
+    const auto &first = _view.Row(row);
+    const std::array<std::uintptr_t, sizeof...(ComponentTypeTs)> firstAddress{
+      reinterpret_cast<std::uintptr_t>(std::get<Indices + 1>(first))...};
+    const auto maxBlockSize =
+      std::min(_view.EntityCount() - row, ComponentPool::kPageSize);
+    blockEntities[0] = std::get<0>(first);
+    std::size_t blockSize = 1;
+    for (; blockSize < maxBlockSize; ++blockSize)
+    {
+      const auto &next = _view.Row(row + blockSize);
+      if (!(... && (reinterpret_cast<std::uintptr_t>(
+                std::get<Indices + 1>(next)) ==
+              firstAddress[Indices] + blockSize * sizeof(ComponentTypeTs))))
+        break;
+      blockEntities[blockSize] = std::get<0>(next);
+    }
+
+    // a block can't go past the end of a page, since pages are allocated
+    // separately (and may happen to be next to each other)
+    if (blockSize > 1)
+    {
+      blockSize = std::min({blockSize, (ComponentPool::kPageSize -
+          viewPools[Indices]->Slot(blockEntities[0]) %
+            ComponentPool::kPageSize)...});
+    }
+
+    if (!_f(Span<const Entity>(blockEntities.data(), blockSize),
+          Span<ComponentTypeTs>(OffsetPointer(std::get<Indices + 1>(first),
+              offsets[Indices]), blockSize)...))
+      return;
+
+    row += blockSize;
+  }
+}
+
+bool ECM::IsGroupMember(const Entity &_entity, const Group &_group) const
+{
+  return this->Pool(_group.types[0])->Slot(_entity) < _group.size;
+}
+
+void ECM::JoinGroup(const Entity &_entity, Group &_group)
+{
+  for (const auto &typeId : _group.types)
+    this->MoveToSlot(_entity, typeId, _group.size);
+  _group.size++;
+}
+
+void ECM::LeaveGroup(const Entity &_entity, Group &_group)
+{
+  _group.size--;
+  for (const auto &typeId : _group.types)
+    this->MoveToSlot(_entity, typeId, _group.size);
+}
+
+void ECM::MoveToSlot(const Entity &_entity, const ComponentTypeId &_typeId,
+    const std::size_t _slot)
+{
+  auto pool = this->Pool(_typeId);
+  const auto slot = pool->Slot(_entity);
+  if (slot == _slot)
+    return;
+
+  const auto displaced = pool->SlotEntity(_slot);
+  pool->SwapSlots(slot, _slot);
+
+  ComponentLookup lookup;
+  for (auto &[compTypes, view] : this->views)
+  {
+    if (!view->HasComponent(_typeId))
+      continue;
+    if (!lookup)
+      lookup = this->Lookup();
+    view->RelinkEntity(_entity, lookup);
+    if (displaced != kNullEntity)
+      view->RelinkEntity(displaced, lookup);
+  }
+}
+
+template<typename ...ComponentTypeTs>
+View<ComponentTypeTs...> *ECM::FindView()
+{
+  SIMPLE_ECM_TRACE_SCOPE("ECM::FindView");
+  std::vector<ComponentTypeId> viewKey {ComponentTypeTs::typeId...};
+
+  auto &usage = this->viewUsage[viewKey];
+  usage.useCount++;
+  usage.lastUse = ++this->viewUseSequence;
 
   // does the view already exist?
   auto iter = this->views.find(viewKey);
   if (iter != this->views.end())
   {
+    SIMPLE_ECM_TRACE_COUNT("view cache hit");
     auto view = static_cast<View<ComponentTypeTs...>*>((iter->second).get());
 
     // add any new entities to the view before using it
-    for (const auto &entity : view->NewEntities())
-      view->AddEntity(entity, this->Component<ComponentTypeTs>(entity)...);
-    view->RemoveNewEntities();
+    SIMPLE_ECM_TRACE_SCOPE("ECM::FindView new entity flush");
+    const auto newEntities = view->NewEntities();
+    if (!newEntities.empty())
+    {
+      const auto lookup = this->Lookup();
+      for (const auto &entity : newEntities)
+        view->AddEntity(entity, lookup);
+      view->RemoveNewEntities();
+    }
 
+    if (!newEntities.empty())
+      this->EnforceViewMemoryBudget(view);
     return view;
   }
 
   // create a new view if one wasn't found
-  View<ComponentTypeTs...> view;
+  SIMPLE_ECM_TRACE_COUNT("view cache miss");
+  SIMPLE_ECM_TRACE_SCOPE("ECM::FindView view creation");
+  auto newView = std::make_unique<View<ComponentTypeTs...>>();
+  newView->SetHugePages(this->hugePages);
+  auto newViewPtr = newView.get();
 
-  // only add entities to the view that have all of the components in viewKey
-  for (const auto &entityCompData : this->entityComponents)
+  // only add entities to the view that have all of the components in viewKey.
+  // They're added in component storage order, so that iterating over the view
+  // walks through component storage in order. Views store storage addresses,
+  // so the offsets to the current values of double buffered components are
+  // undone
+  const std::array<ComponentPool *, sizeof...(ComponentTypeTs)> viewPools{
+    this->Pool(ComponentTypeTs::typeId)...};
+  if (std::find(viewPools.begin(), viewPools.end(), nullptr) ==
+      viewPools.end())
   {
-    const auto entity = entityCompData.first;
+    auto offsets = this->ViewOffsets<ComponentTypeTs...>();
+    for (auto &offset : offsets)
+      offset = -offset;
+    this->EachTransientInPools<ComponentTypeTs...>(
+        std::function<bool(const Entity &, ComponentTypeTs*...)>(
+          [newViewPtr](const Entity &_entity, ComponentTypeTs*... _components)
+          {
+            newViewPtr->AddEntity(_entity, _components...);
+            return true;
+          }), viewPools, offsets,
+        std::index_sequence_for<ComponentTypeTs...>());
+  }
 
-    if (!this->HasAllComponents(entity, viewKey))
-      continue;
+  usage.buildCount++;
+  this->views.emplace(viewKey, std::move(newView));
+  this->EnforceViewMemoryBudget(newViewPtr);
+  return newViewPtr;
+}
+
+void ECM::EnforceViewMemoryBudget(const BaseView *_keep)
+{
+  if (!this->viewMemoryBudget)
+    return;
 
-    view.AddEntity(entity, this->Component<ComponentTypeTs>(entity)...);
+  std::size_t totalBytes = 0;
+  std::vector<std::pair<std::uint64_t, const std::vector<ComponentTypeId> *>>
+    candidates;
+  for (const auto &[compTypes, view] : this->views)
+  {
+    totalBytes += view->MemoryStats().TotalBytes();
+    if (view.get() != _keep && !view->Pinned() && !view->Registered())
+      candidates.emplace_back(this->viewUsage[compTypes].lastUse, &compTypes);
   }
+  if (totalBytes <= this->viewMemoryBudget)
+    return;
 
-  this->views.emplace(std::make_pair(viewKey,
-          std::make_unique<View<ComponentTypeTs...>>(view)));
-  return static_cast<View<ComponentTypeTs...>*>(this->views[viewKey].get());
+  // evict the least recently used views first
+  std::sort(candidates.begin(), candidates.end());
+  for (const auto &[lastUse, compTypes] : candidates)
+  {
+    if (totalBytes <= this->viewMemoryBudget)
+      break;
+
+    SIMPLE_ECM_TRACE_COUNT("view eviction");
+    auto iter = this->views.find(*compTypes);
+    totalBytes -= iter->second->MemoryStats().TotalBytes();
+    this->viewUsage[*compTypes].evictionCount++;
+    this->views.erase(iter);
+  }
 }
 
-bool ECM::HasComponent(const Entity &_entity,
-    const ComponentTypeId &_typeId) const
+bool ECM::CompactStorage(const std::vector<ComponentTypeId> *_first)
 {
-  auto typeMapIter = this->componentTypeIndex.find(_entity);
-  return typeMapIter != this->componentTypeIndex.end() &&
-         typeMapIter->second.find(_typeId) != typeMapIter->second.end();
+  SIMPLE_ECM_TRACE_SCOPE("ECM::Compact");
+  for (const auto &[compTypes, view] : this->views)
+  {
+    if (view->Pinned())
+      return false;
+  }
+
+  const auto lookup = this->Lookup();
+
+  std::vector<std::pair<std::uint64_t, BaseView *>> viewOrder;
+  for (const auto &[compTypes, view] : this->views)
+  {
+    // add new entities to the view first, so that they're laid out with the
+    // rest of the view
+    for (const auto &entity : view->NewEntities())
+      view->AddEntity(entity, lookup);
+    view->RemoveNewEntities();
+
+    auto priority = this->viewUsage[compTypes].useCount;
+    if (_first && compTypes == *_first)
+      priority = std::numeric_limits<std::uint64_t>::max();
+    viewOrder.emplace_back(priority, view.get());
+  }
+  std::stable_sort(viewOrder.begin(), viewOrder.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first > _b.first;
+      });
+
+  // lay out each component type in the order of the most important view that
+  // has it. Component types that aren't in a view are just packed
+  std::unordered_map<ComponentTypeId, std::vector<Entity>> orders;
+  for (const auto &[typeId, pool] : this->pools)
+    orders[typeId];
+
+  // groups come first, since their members have to stay at the front of
+  // each owned pool
+  for (const auto &group : this->groups)
+  {
+    std::vector<Entity> members;
+    auto firstPool = this->Pool(group->types[0]);
+    for (std::size_t slot = 0; slot < group->size; ++slot)
+      members.push_back(firstPool->SlotEntity(slot));
+    for (const auto &typeId : group->types)
+      orders[typeId] = members;
+  }
+
+  for (const auto &[priority, view] : viewOrder)
+  {
+    std::vector<Entity> viewEntities;
+    for (auto &[typeId, order] : orders)
+    {
+      if (!order.empty() || !view->HasComponent(typeId) ||
+          this->groupOwners.find(typeId) != this->groupOwners.end())
+        continue;
+      if (viewEntities.empty())
+        viewEntities = view->RowEntities();
+      order = viewEntities;
+    }
+  }
+  for (auto &[typeId, pool] : this->pools)
+    pool->Compact(orders[typeId]);
+
+  for (auto &[compTypes, view] : this->views)
+    view->Relink(lookup);
+
+  this->layoutChanges = 0;
+  return true;
 }
 
-template<typename ComponentTypeT>
-ComponentTypeT *ECM::Component(const Entity &_entity) const
+bool ECM::HasComponent(const Entity &_entity,
+    const ComponentTypeId &_typeId) const
 {
-  if (!this->HasComponent(_entity, ComponentTypeT::typeId))
-    return nullptr;
-
-  const auto componentIdx =
-    this->componentTypeIndex.at(_entity).at(ComponentTypeT::typeId);
-  const auto baseCompPtr =
-    this->entityComponents.at(_entity).at(componentIdx).get();
-  return static_cast<ComponentTypeT*>(baseCompPtr);
+  auto pool = this->Pool(_typeId);
+  return pool && pool->Has(_entity);
 }
 
 bool ECM::HasAllComponents(const Entity &_entity,
@@ -258,4 +2446,82 @@ bool ECM::HasAllComponents(const Entity &_entity,
   return true;
 }
 
+void ECM::IndexName(const Entity &_entity)
+{
+  auto pool = this->Pool(Name::typeId);
+  auto component = pool ? pool->Component(_entity) : nullptr;
+
+  // unnamed entities aren't indexed. They would all share one key, which
+  // makes unindexing one of them a scan over all of them
+  if (component && !static_cast<Name *>(component)->name.Str().empty())
+    this->nameIndex.emplace(static_cast<Name *>(component)->name, _entity);
+}
+
+void ECM::UnindexName(const Entity &_entity)
+{
+  auto pool = this->Pool(Name::typeId);
+  auto component = pool ? pool->Component(_entity) : nullptr;
+  if (!component || static_cast<Name *>(component)->name.Str().empty())
+    return;
+
+  auto range =
+    this->nameIndex.equal_range(static_cast<Name *>(component)->name);
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if (iter->second == _entity)
+    {
+      this->nameIndex.erase(iter);
+      return;
+    }
+  }
+}
+
+std::string ECM::ComponentNames(
+    const std::vector<ComponentTypeId> &_compTypes) const
+{
+  std::string names;
+  for (const auto &typeId : _compTypes)
+  {
+    if (!names.empty())
+      names += ", ";
+    auto pool = this->Pool(typeId);
+    names += pool ? pool->Metadata().name : std::to_string(typeId);
+  }
+  return names;
+}
+
+ComponentPool *ECM::Pool(const ComponentTypeId &_typeId) const
+{
+  auto iter = this->pools.find(_typeId);
+  if (iter == this->pools.end())
+    return nullptr;
+  return iter->second.get();
+}
+
+template<typename ComponentTypeT>
+ComponentPool &ECM::PoolOf()
+{
+  return this->PoolOf(ComponentMetadataOf<ComponentTypeT>());
+}
+
+ComponentPool &ECM::PoolOf(const ComponentMetadata &_metadata)
+{
+  auto &pool = this->pools[_metadata.typeId];
+  if (!pool)
+  {
+    pool = std::make_unique<ComponentPool>(_metadata);
+    pool->SetHugePages(this->hugePages);
+  }
+  return *pool;
+}
+
+ComponentLookup ECM::Lookup() const
+{
+  return [this](const Entity &_entity, const ComponentTypeId &_typeId)
+    {
+      auto pool = this->Pool(_typeId);
+      return pool ? pool->ComponentStorage(_entity) : nullptr;
+    };
+}
+
 #endif
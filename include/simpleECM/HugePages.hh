@@ -0,0 +1,339 @@
+#ifndef HUGE_PAGES_HH_
+#define HUGE_PAGES_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#ifdef __linux__
+  #include <sys/mman.h>
+#endif // __linux__
+
+/// \brief Whether memory can be mapped for transparent huge pages on this
+/// platform (only Linux supports it)
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+constexpr bool kHugePagesSupported{true};
+#else
+constexpr bool kHugePagesSupported{false};
+#endif
+
+/// \brief The size of a (transparent) huge page on x86-64 and most aarch64
+/// kernels. Memory that is meant to be backed by huge pages is allocated in
+/// multiples of this, aligned to this
+constexpr std::size_t kHugePageBytes{2 * 1024 * 1024};
+
+/// \brief Memory that was mapped for huge pages
+struct HugePageMapping
+{
+  /// \brief The start of the memory, which is aligned to kHugePageBytes
+  unsigned char *data{nullptr};
+
+  /// \brief The size of the memory in bytes, which is a multiple of
+  /// kHugePageBytes
+  std::size_t bytes{0};
+
+  /// \brief Whether the kernel was asked to back the memory with huge pages.
+  /// The kernel may still use regular pages for some or all of it (if huge
+  /// pages are fragmented, for example)
+  bool huge{false};
+};
+
+/// \brief Map anonymous memory that is aligned to kHugePageBytes, and ask the
+/// kernel to back it with transparent huge pages (madvise(MADV_HUGEPAGE)).
+/// If the kernel doesn't support transparent huge pages, or they're turned
+/// off, the memory is still mapped, and is backed by regular pages
+/// \param[in] _bytes The minimum size of the memory, which is rounded up to a
+/// multiple of kHugePageBytes
+/// \return The mapping
+/// \throws std::bad_alloc if memory couldn't be mapped, or if
+/// kHugePagesSupported is false
+HugePageMapping MapHugePages(const std::size_t _bytes)
+{
+  HugePageMapping mapping;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  const auto bytes =
+    (_bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+
+  // map an extra huge page so that an aligned range can be cut out of it
+  const auto mappedBytes = bytes + kHugePageBytes;
+  auto mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED)
+    throw std::bad_alloc();
+
+  auto start = static_cast<unsigned char *>(mapped);
+  auto aligned = reinterpret_cast<unsigned char *>(
+      (reinterpret_cast<std::uintptr_t>(start) + kHugePageBytes - 1) /
+      kHugePageBytes * kHugePageBytes);
+  if (aligned != start)
+    munmap(start, aligned - start);
+  const auto end = start + mappedBytes;
+  if (aligned + bytes != end)
+    munmap(aligned + bytes, end - (aligned + bytes));
+
+  mapping.data = aligned;
+  mapping.bytes = bytes;
+  mapping.huge = madvise(aligned, bytes, MADV_HUGEPAGE) == 0;
+#else
+  (void)_bytes;
+  throw std::bad_alloc();
+#endif
+  return mapping;
+}
+
+/// \brief Unmap memory that was mapped by MapHugePages
+/// \param[in] _mapping The mapping
+void UnmapHugePages(const HugePageMapping &_mapping)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  munmap(_mapping.data, _mapping.bytes);
+#else
+  (void)_mapping;
+#endif
+}
+
+/// \brief Hands out blocks of memory from large huge page mappings, for
+/// storage that allocates many blocks that are smaller than a huge page (the
+/// pages of a ComponentPool, for example). Blocks that are freed are re-used
+/// by later blocks of the same size, and all of the memory is unmapped when
+/// the arena is destroyed. Arenas can only be used if kHugePagesSupported is
+/// true
+class HugePageArena
+{
+  /// \brief Constructor
+  public: HugePageArena() = default;
+
+  /// \brief Destructor, which unmaps all of the arena's memory. Blocks that
+  /// are still in use become invalid
+  public: ~HugePageArena();
+
+  /// \brief Arenas own mapped memory, so they can't be copied
+  public: HugePageArena(const HugePageArena &) = delete;
+
+  /// \brief Arenas own mapped memory, so they can't be copied
+  public: HugePageArena &operator=(const HugePageArena &) = delete;
+
+  /// \brief Allocate a block
+  /// \param[in] _bytes The size of the block
+  /// \param[in] _alignment The alignment of the block, which must be a power
+  /// of two that is at most kHugePageBytes
+  /// \return The block
+  /// \throws std::bad_alloc if memory couldn't be mapped
+  public: unsigned char *Allocate(const std::size_t _bytes,
+              const std::size_t _alignment);
+
+  /// \brief Free a block
+  /// \param[in] _block The block, which was returned by Allocate
+  /// \param[in] _bytes The size that was given to Allocate
+  public: void Free(unsigned char *_block, const std::size_t _bytes);
+
+  /// \brief Get the number of bytes that are mapped
+  /// \return The number of bytes
+  public: std::size_t MappedBytes() const;
+
+  /// \brief Get the number of mapped bytes that the kernel was asked to back
+  /// with huge pages
+  /// \return The number of bytes
+  public: std::size_t HugePageBytes() const;
+
+  /// \brief The size of the first mapping. Later mappings double in size, up
+  /// to kMaxMappingBytes, so that a large arena doesn't need many mappings
+  public: constexpr const static std::size_t kMinMappingBytes{kHugePageBytes};
+
+  /// \brief The largest size of a mapping (unless a single block is larger)
+  public: constexpr const static std::size_t kMaxMappingBytes{
+            32 * kHugePageBytes};
+
+  /// \brief The memory that was mapped, in mapping order
+  private: std::vector<HugePageMapping> mappings;
+
+  /// \brief The next unused byte of the last mapping
+  private: unsigned char *next{nullptr};
+
+  /// \brief The end of the last mapping
+  private: unsigned char *end{nullptr};
+
+  /// \brief Blocks that were freed, by size. A freed block is only re-used
+  /// by a block of the same size, which is what happens when all of the
+  /// blocks are the same size (the pages of a pool)
+  private: std::unordered_map<std::size_t,
+            std::vector<unsigned char *>> freeBlocks;
+};
+
+/// \brief An allocator for containers that can hold a lot of elements (the
+/// rows of a view, for example). Allocations of at least kHugePageBytes get
+/// their own huge page mapping if the allocator is told to use huge pages;
+/// everything else is allocated with operator new. Whether huge pages are
+/// used is part of the allocator's state, and it moves with a container's
+/// contents when the container is move assigned
+template<typename T>
+class HugePageAllocator
+{
+  /// \brief The type of element that is allocated
+  public: using value_type = T;
+
+  /// \brief Allocators move with the contents of containers
+  public: using propagate_on_container_move_assignment = std::true_type;
+
+  /// \brief Allocators move with the contents of containers
+  public: using propagate_on_container_swap = std::true_type;
+
+  /// \brief Constructor
+  /// \param[in] _hugePages Whether large allocations should use huge pages
+  public: explicit HugePageAllocator(const bool _hugePages = false)
+    : hugePages(_hugePages)
+  {
+  }
+
+  /// \brief Conversion from an allocator of another type
+  /// \param[in] _other The other allocator
+  public: template<typename U>
+          HugePageAllocator(const HugePageAllocator<U> &_other)
+    : hugePages(_other.HugePages())
+  {
+  }
+
+  /// \brief Allocate memory for elements
+  /// \param[in] _count The number of elements
+  /// \return The memory
+  /// \throws std::bad_alloc if the memory couldn't be allocated
+  public: T *allocate(const std::size_t _count)
+  {
+    const auto bytes = _count * sizeof(T);
+    if (this->UsesMapping(bytes))
+      return reinterpret_cast<T *>(MapHugePages(bytes).data);
+    return static_cast<T *>(::operator new(bytes,
+          std::align_val_t{alignof(T)}));
+  }
+
+  /// \brief Free memory that was returned by allocate
+  /// \param[in] _data The memory
+  /// \param[in] _count The number of elements that was given to allocate
+  public: void deallocate(T *_data, const std::size_t _count)
+  {
+    const auto bytes = _count * sizeof(T);
+    if (this->UsesMapping(bytes))
+    {
+      HugePageMapping mapping;
+      mapping.data = reinterpret_cast<unsigned char *>(_data);
+      mapping.bytes =
+        (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+      UnmapHugePages(mapping);
+      return;
+    }
+    ::operator delete(_data, std::align_val_t{alignof(T)});
+  }
+
+  /// \brief Check if large allocations use huge pages
+  /// \return true if they do, false otherwise
+  public: bool HugePages() const
+  {
+    return this->hugePages;
+  }
+
+  /// \brief Get the number of bytes of an allocation that the kernel was
+  /// asked to back with huge pages
+  /// \param[in] _count The number of elements that were allocated
+  /// \return The number of bytes, which is 0 if the allocation wasn't mapped
+  /// for huge pages
+  public: std::size_t HugePageBytes(const std::size_t _count) const
+  {
+    const auto bytes = _count * sizeof(T);
+    return this->UsesMapping(bytes) ? bytes : 0;
+  }
+
+  /// \brief Check if an allocation gets its own huge page mapping
+  /// \param[in] _bytes The size of the allocation
+  /// \return true if it does, false otherwise
+  private: bool UsesMapping(const std::size_t _bytes) const
+  {
+    return kHugePagesSupported && this->hugePages &&
+      _bytes >= kHugePageBytes && alignof(T) <= kHugePageBytes;
+  }
+
+  /// \brief Whether large allocations use huge pages
+  private: bool hugePages{false};
+};
+
+/// \brief Check if two allocators can free each other's memory
+/// \param[in] _a An allocator
+/// \param[in] _b Another allocator
+/// \return true if they use huge pages for the same allocations
+template<typename T, typename U>
+bool operator==(const HugePageAllocator<T> &_a,
+    const HugePageAllocator<U> &_b)
+{
+  return _a.HugePages() == _b.HugePages();
+}
+
+/// \brief Check if two allocators can't free each other's memory
+/// \param[in] _a An allocator
+/// \param[in] _b Another allocator
+/// \return true if they don't use huge pages for the same allocations
+template<typename T, typename U>
+bool operator!=(const HugePageAllocator<T> &_a,
+    const HugePageAllocator<U> &_b)
+{
+  return !(_a == _b);
+}
+
+HugePageArena::~HugePageArena()
+{
+  for (const auto &mapping : this->mappings)
+    UnmapHugePages(mapping);
+}
+
+unsigned char *HugePageArena::Allocate(const std::size_t _bytes,
+    const std::size_t _alignment)
+{
+  auto &freed = this->freeBlocks[_bytes];
+  if (!freed.empty())
+  {
+    auto block = freed.back();
+    freed.pop_back();
+    return block;
+  }
+
+  auto aligned = reinterpret_cast<unsigned char *>(
+      (reinterpret_cast<std::uintptr_t>(this->next) + _alignment - 1) /
+      _alignment * _alignment);
+  if (!this->next || aligned + _bytes > this->end)
+  {
+    // the rest of the last mapping is left unused
+    auto bytes = this->mappings.empty() ? kMinMappingBytes :
+      std::min(this->mappings.back().bytes * 2, kMaxMappingBytes);
+    bytes = std::max(bytes, _bytes);
+    const auto mapping = MapHugePages(bytes);
+    this->mappings.push_back(mapping);
+    this->end = mapping.data + mapping.bytes;
+    aligned = mapping.data;
+  }
+  this->next = aligned + _bytes;
+  return aligned;
+}
+
+void HugePageArena::Free(unsigned char *_block, const std::size_t _bytes)
+{
+  this->freeBlocks[_bytes].push_back(_block);
+}
+
+std::size_t HugePageArena::MappedBytes() const
+{
+  std::size_t bytes = 0;
+  for (const auto &mapping : this->mappings)
+    bytes += mapping.bytes;
+  return bytes;
+}
+
+std::size_t HugePageArena::HugePageBytes() const
+{
+  std::size_t bytes = 0;
+  for (const auto &mapping : this->mappings)
+    bytes += mapping.huge ? mapping.bytes : 0;
+  return bytes;
+}
+
+#endif
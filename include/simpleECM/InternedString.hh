@@ -0,0 +1,206 @@
+#ifndef INTERNED_STRING_HH_
+#define INTERNED_STRING_HH_
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+/// \brief A handle to a string in a table that is shared by the whole
+/// process. Every distinct string is stored once, so a handle is the size of a
+/// pointer, copying it never allocates, and two handles are equal if and only
+/// if they point at the same table entry. Strings are never removed from the
+/// table, so interning should be used for strings that repeat or live as long
+/// as the program (names, for example), not for arbitrary text
+class InternedString
+{
+  /// \brief Constructor for the empty string
+  public: InternedString();
+
+  /// \brief Constructor, which adds the string to the table if it isn't
+  /// there already
+  /// \param[in] _str The string
+  public: InternedString(const std::string &_str);
+
+  /// \brief Constructor, which adds the string to the table if it isn't
+  /// there already
+  /// \param[in] _str The string
+  public: InternedString(const char *_str);
+
+  /// \brief Get the string
+  /// \return The string, which stays valid for the life of the program
+  public: const std::string &Str() const;
+
+  /// \brief Get the string
+  /// \return The string, which stays valid for the life of the program
+  public: operator const std::string &() const;
+
+  /// \brief Check if two handles refer to the same string. This compares
+  /// pointers, not characters
+  /// \param[in] _other The other handle
+  /// \return true if the strings are equal, false otherwise
+  public: bool operator==(const InternedString &_other) const;
+
+  /// \brief Check if two handles refer to different strings
+  /// \param[in] _other The other handle
+  /// \return true if the strings are different, false otherwise
+  public: bool operator!=(const InternedString &_other) const;
+
+  /// \brief Find the handle of a string without adding the string to the
+  /// table
+  /// \param[in] _str The string
+  /// \param[out] _interned The handle, if the string is in the table
+  /// \return true if the string is in the table, false otherwise
+  public: static bool Find(const std::string &_str, InternedString &_interned);
+
+  /// \brief Get the number of distinct strings in the table
+  /// \return The number of strings
+  public: static std::size_t TableSize();
+
+  /// \brief Estimate the memory used by the table
+  /// \return The number of bytes
+  public: static std::size_t TableBytes();
+
+  /// \brief Write the string to a stream
+  /// \param[in] _os The stream
+  /// \param[in] _str The string
+  /// \return _os
+  public: friend std::ostream &operator<<(std::ostream &_os,
+              const InternedString &_str)
+  {
+    _os << _str.Str();
+    return _os;
+  }
+
+  /// \brief Constructor for a string that is in the table already
+  /// \param[in] _entry The string's table entry
+  private: explicit InternedString(const std::string *_entry);
+
+  /// \brief Find a string in the table, adding it if needed
+  /// \param[in] _str The string
+  /// \return The string's table entry
+  private: static const std::string *Intern(const std::string &_str);
+
+  /// \brief The shared table. Elements of a std::unordered_set never move,
+  /// so handles can point at them
+  private: static std::unordered_set<std::string> &Table();
+
+  /// \brief Guards the table, since strings may be interned from several
+  /// threads. Reading an interned string doesn't need the lock
+  private: static std::mutex &TableMutex();
+
+  /// \brief The string's table entry
+  private: const std::string *str;
+};
+
+/// \brief Hash functor for InternedString, which hashes the table entry
+/// instead of the characters
+namespace std
+{
+  template<>
+  struct hash<InternedString>
+  {
+    std::size_t operator()(const InternedString &_str) const
+    {
+      return std::hash<const std::string *>()(&_str.Str());
+    }
+  };
+}
+
+InternedString::InternedString()
+{
+  // the empty string is interned once, since components are often default
+  // constructed
+  static const std::string *const empty = Intern(std::string());
+  this->str = empty;
+}
+
+InternedString::InternedString(const std::string &_str)
+  : str(Intern(_str))
+{
+}
+
+InternedString::InternedString(const char *_str)
+  : str(Intern(_str))
+{
+}
+
+InternedString::InternedString(const std::string *_entry)
+  : str(_entry)
+{
+}
+
+const std::string &InternedString::Str() const
+{
+  return *this->str;
+}
+
+InternedString::operator const std::string &() const
+{
+  return *this->str;
+}
+
+bool InternedString::operator==(const InternedString &_other) const
+{
+  return this->str == _other.str;
+}
+
+bool InternedString::operator!=(const InternedString &_other) const
+{
+  return this->str != _other.str;
+}
+
+bool InternedString::Find(const std::string &_str,
+    InternedString &_interned)
+{
+  std::lock_guard<std::mutex> lock(TableMutex());
+  const auto &table = Table();
+  auto iter = table.find(_str);
+  if (iter == table.end())
+    return false;
+  _interned = InternedString(&*iter);
+  return true;
+}
+
+std::size_t InternedString::TableSize()
+{
+  std::lock_guard<std::mutex> lock(TableMutex());
+  return Table().size();
+}
+
+std::size_t InternedString::TableBytes()
+{
+  std::lock_guard<std::mutex> lock(TableMutex());
+  const auto &table = Table();
+  auto bytes = table.bucket_count() * sizeof(void *) +
+    table.size() * (sizeof(void *) + sizeof(std::string));
+  for (const auto &entry : table)
+  {
+    // short strings are stored inside the std::string
+    if (entry.capacity() > std::string().capacity())
+      bytes += entry.capacity() + 1;
+  }
+  return bytes;
+}
+
+const std::string *InternedString::Intern(const std::string &_str)
+{
+  std::lock_guard<std::mutex> lock(TableMutex());
+  return &*Table().insert(_str).first;
+}
+
+std::unordered_set<std::string> &InternedString::Table()
+{
+  static std::unordered_set<std::string> table;
+  return table;
+}
+
+std::mutex &InternedString::TableMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef MEMORY_STATS_HH_
+#define MEMORY_STATS_HH_
+
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "simpleECM/Types.hh"
+
+/// \brief Estimate the number of bytes used by a std::unordered_map or
+/// std::unordered_set (the bucket array, plus a node per element). This is an
+/// estimate since the node layout is up to the standard library
+/// \param[in] _container The container
+/// \return The estimated number of bytes used by _container's heap memory
+template<typename UnorderedContainerT>
+std::size_t UnorderedMemoryBytes(const UnorderedContainerT &_container)
+{
+  using ValueType = typename UnorderedContainerT::value_type;
+  return _container.bucket_count() * sizeof(void *) +
+    _container.size() * (sizeof(void *) + sizeof(ValueType));
+}
+
+/// \brief Get the number of bytes used by a std::vector
+/// \param[in] _vec The vector
+/// \return The number of bytes used by _vec's heap memory
+template<typename T, typename AllocatorT>
+std::size_t VectorMemoryBytes(const std::vector<T, AllocatorT> &_vec)
+{
+  return _vec.capacity() * sizeof(T);
+}
+
+/// \brief Memory used by the storage of a single component type
+struct ComponentMemoryStats
+{
+  /// \brief The component type
+  ComponentTypeId typeId{kInvalidComponent};
+
+  /// \brief The name of the component type
+  std::string name;
+
+  /// \brief The number of components that are stored
+  std::size_t count{0};
+
+  /// \brief Bytes used by the components themselves
+  std::size_t dataBytes{0};
+
+  /// \brief Bytes used to look up components (entity to component maps, etc.)
+  std::size_t indexBytes{0};
+
+  /// \brief Bytes that are allocated, but not used by a component
+  std::size_t slackBytes{0};
+
+  /// \brief Bytes of huge page mappings that the components are stored in
+  /// (see ComponentPool::SetHugePages). The kernel was asked to back them
+  /// with huge pages, but may not have been able to
+  std::size_t hugePageBytes{0};
+
+  /// \brief Get the total number of bytes used by the component storage
+  /// \return The total number of bytes
+  std::size_t TotalBytes() const
+  {
+    return this->dataBytes + this->indexBytes + this->slackBytes;
+  }
+};
+
+/// \brief Memory used by a single view
+struct ViewMemoryStats
+{
+  /// \brief The component types of the view, in view order
+  std::vector<ComponentTypeId> componentTypes;
+
+  /// \brief The names of the component types of the view, in view order
+  std::string name;
+
+  /// \brief The number of entities (rows) in the view
+  std::size_t rows{0};
+
+  /// \brief Bytes used by the rows of component data
+  std::size_t rowBytes{0};
+
+  /// \brief Bytes used to look up rows and to keep track of the view's
+  /// entities
+  std::size_t indexBytes{0};
+
+  /// \brief Bytes that are allocated, but not used by a row
+  std::size_t slackBytes{0};
+
+  /// \brief Bytes of the rows that are in huge page mappings (see
+  /// BaseView::SetHugePages)
+  std::size_t hugePageBytes{0};
+
+  /// \brief Get the total number of bytes used by the view
+  /// \return The total number of bytes
+  std::size_t TotalBytes() const
+  {
+    return this->rowBytes + this->indexBytes + this->slackBytes;
+  }
+};
+
+/// \brief Memory used by an index that the ECM keeps up to date (a spatial
+/// index, for example)
+struct IndexMemoryStats
+{
+  /// \brief What the index is over
+  std::string name;
+
+  /// \brief The number of entities in the index
+  std::size_t entries{0};
+
+  /// \brief Bytes used by the index
+  std::size_t bytes{0};
+};
+
+/// \brief Memory used by an ECM. All of the numbers are for heap memory that
+/// is owned by the ECM, and container overhead is estimated
+struct EcmMemoryStats
+{
+  /// \brief The number of entities
+  std::size_t entities{0};
+
+  /// \brief Bytes used by the entity table
+  std::size_t entityBytes{0};
+
+  /// \brief Memory used by each component type's storage
+  std::vector<ComponentMemoryStats> components;
+
+  /// \brief Memory used by each view
+  std::vector<ViewMemoryStats> views;
+
+  /// \brief Bytes used by the ECM to keep track of its views (not including
+  /// the views themselves)
+  std::size_t viewIndexBytes{0};
+
+  /// \brief Memory used by each index
+  std::vector<IndexMemoryStats> indexes;
+
+  /// \brief Get the total number of bytes used by the ECM
+  /// \return The total number of bytes
+  std::size_t TotalBytes() const
+  {
+    auto total = this->entityBytes + this->viewIndexBytes;
+    for (const auto &component : this->components)
+      total += component.TotalBytes();
+    for (const auto &view : this->views)
+      total += view.TotalBytes();
+    for (const auto &index : this->indexes)
+      total += index.bytes;
+    return total;
+  }
+
+  /// \brief Get the number of bytes of component storage and views that are
+  /// in huge page mappings
+  /// \return The number of bytes
+  std::size_t HugePageBytes() const
+  {
+    std::size_t total = 0;
+    for (const auto &component : this->components)
+      total += component.hugePageBytes;
+    for (const auto &view : this->views)
+      total += view.hugePageBytes;
+    return total;
+  }
+
+  /// \brief Write the memory stats in human readable form
+  /// \param[in] _os The stream to write to
+  /// \param[in] _stats The memory stats
+  /// \return _os
+  friend std::ostream &operator<<(std::ostream &_os,
+      const EcmMemoryStats &_stats)
+  {
+    _os << "Entities: " << _stats.entities << " (" << _stats.entityBytes
+      << " bytes)" << std::endl;
+
+    _os << "Component storage:" << std::endl;
+    for (const auto &component : _stats.components)
+    {
+      _os << "  " << std::left << std::setw(24) << component.name << std::right
+        << " count " << std::setw(9) << component.count
+        << "  data " << std::setw(11) << component.dataBytes
+        << "  index " << std::setw(11) << component.indexBytes
+        << "  slack " << std::setw(11) << component.slackBytes << std::endl;
+    }
+
+    _os << "Views: " << _stats.views.size() << " (" << _stats.viewIndexBytes
+      << " bytes of view bookkeeping)" << std::endl;
+    for (const auto &view : _stats.views)
+    {
+      _os << "  <" << view.name << ">" << std::endl
+        << "    rows " << std::setw(9) << view.rows
+        << "  data " << std::setw(11) << view.rowBytes
+        << "  index " << std::setw(11) << view.indexBytes
+        << "  slack " << std::setw(11) << view.slackBytes << std::endl;
+    }
+
+    if (!_stats.indexes.empty())
+    {
+      _os << "Indexes: " << _stats.indexes.size() << std::endl;
+      for (const auto &index : _stats.indexes)
+      {
+        _os << "  " << std::left << std::setw(24) << index.name << std::right
+          << " entries " << std::setw(9) << index.entries
+          << "  bytes " << std::setw(11) << index.bytes << std::endl;
+      }
+    }
+
+    if (_stats.HugePageBytes() > 0)
+    {
+      _os << "Huge page mappings: " << _stats.HugePageBytes() << " bytes"
+        << std::endl;
+    }
+
+    _os << "Total: " << _stats.TotalBytes() << " bytes" << std::endl;
+    return _os;
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef SHARDED_ECM_HH_
+#define SHARDED_ECM_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "simpleECM/Ecm.hh"
+#include "simpleECM/Trace.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief A world that is split into several ECMs (shards), for example by
+/// partitioning space. Each shard can be used on its own thread, and entities
+/// are moved between shards in batches, along with all of their components.
+/// Every shard creates entities from its own range, so an entity keeps its ID
+/// when it moves to another shard
+class ShardedECM
+{
+  /// \brief Constructor
+  /// \param[in] _numShards The number of shards (at least 1)
+  public: explicit ShardedECM(const std::size_t _numShards);
+
+  /// \brief Get the number of shards
+  /// \return The number of shards
+  public: std::size_t ShardCount() const;
+
+  /// \brief Get a shard
+  /// \param[in] _shard The shard, which must be less than ShardCount()
+  /// \return The shard's ECM
+  public: ECM &Shard(const std::size_t _shard);
+
+  /// \brief Get a shard
+  /// \param[in] _shard The shard, which must be less than ShardCount()
+  /// \return The shard's ECM
+  public: const ECM &Shard(const std::size_t _shard) const;
+
+  /// \brief Move entities, along with all of their components, from one shard
+  /// to another. The components are moved a column per component type (see
+  /// ECM::ExtractEntities), instead of being added and removed one at a time
+  /// \param[in] _entities The entities to move. Entities that aren't in _from
+  /// are skipped
+  /// \param[in] _from The shard the entities are in
+  /// \param[in] _to The shard to move the entities to
+  /// \return The number of entities that were moved
+  public: std::size_t Migrate(const std::vector<Entity> &_entities,
+              const std::size_t _from, const std::size_t _to);
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components in every shard. Each shard is iterated on its own thread (see
+  /// ECM::Each), so the callback is called from several threads at once
+  /// \param[in] _f The callback function to be executed. Returning false stops
+  /// the iteration of the calling thread's shard only
+  public: template<typename ...ComponentTypeTs>
+          void Each(std::function<bool(const Entity &_entity,
+                                       ComponentTypeTs*...)> _f);
+
+  /// \brief The number of low bits of an entity that are numbered within its
+  /// shard's range. Shard i creates entities starting at i << kShardShift
+  public: constexpr const static std::size_t kShardShift{48};
+
+  /// \brief The shards
+  private: std::vector<std::unique_ptr<ECM>> shards;
+};
+
+ShardedECM::ShardedECM(const std::size_t _numShards)
+{
+  for (std::size_t shard = 0; shard < std::max<std::size_t>(1, _numShards);
+       ++shard)
+  {
+    this->shards.push_back(std::make_unique<ECM>(
+          static_cast<Entity>(shard) << kShardShift));
+  }
+}
+
+std::size_t ShardedECM::ShardCount() const
+{
+  return this->shards.size();
+}
+
+ECM &ShardedECM::Shard(const std::size_t _shard)
+{
+  return *this->shards[_shard];
+}
+
+const ECM &ShardedECM::Shard(const std::size_t _shard) const
+{
+  return *this->shards[_shard];
+}
+
+std::size_t ShardedECM::Migrate(const std::vector<Entity> &_entities,
+    const std::size_t _from, const std::size_t _to)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ShardedECM::Migrate");
+  if (_from == _to)
+    return 0;
+
+  auto batch = this->shards[_from]->ExtractEntities(_entities);
+  const auto numMoved = batch.entities.size();
+  this->shards[_to]->InsertEntities(std::move(batch));
+  return numMoved;
+}
+
+template<typename ...ComponentTypeTs>
+void ShardedECM::Each(
+    std::function<bool(const Entity &_entity, ComponentTypeTs*...)> _f)
+{
+  SIMPLE_ECM_TRACE_SCOPE("ShardedECM::Each");
+
+  // the calling thread iterates over the first shard
+  std::vector<std::thread> workers;
+  for (std::size_t shard = 1; shard < this->shards.size(); ++shard)
+  {
+    workers.emplace_back([this, &_f, shard]()
+        {
+          this->shards[shard]->Each<ComponentTypeTs...>(_f);
+        });
+  }
+  this->shards[0]->Each<ComponentTypeTs...>(_f);
+  for (auto &worker : workers)
+    worker.join();
+}
+
+#endif
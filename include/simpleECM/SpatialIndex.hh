@@ -0,0 +1,271 @@
+#ifndef SPATIAL_INDEX_HH_
+#define SPATIAL_INDEX_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "simpleECM/Components.hh"
+#include "simpleECM/MemoryStats.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief Get the position of a Position component, for spatial indexing
+/// \param[in] _position The component
+/// \return The position
+Vector3i SpatialPosition(const Position &_position)
+{
+  return _position.data;
+}
+
+/// \brief Get the position of a Pose component, for spatial indexing
+/// \param[in] _pose The component
+/// \return The position
+Vector3i SpatialPosition(const Pose &_pose)
+{
+  return _pose.position;
+}
+
+/// \brief A uniform grid of cubic cells that keeps track of which cell each
+/// entity is in. Entities only move between cells when their cell changes, so
+/// updating an entity that moved a little is a single hash lookup
+class SpatialGrid
+{
+  /// \brief Constructor
+  /// \param[in] _cellSize The length of a cell's edge (at least 1)
+  public: explicit SpatialGrid(const int _cellSize);
+
+  /// \brief Get the length of a cell's edge
+  /// \return The cell size
+  public: int CellSize() const;
+
+  /// \brief Get the number of entities in the grid
+  /// \return The number of entities
+  public: std::size_t Size() const;
+
+  /// \brief Add an entity to the grid. Nothing happens if the entity is in the
+  /// grid already
+  /// \param[in] _entity The entity
+  /// \param[in] _position The entity's position
+  public: void Insert(const Entity &_entity, const Vector3i &_position);
+
+  /// \brief Move an entity to the cell of its new position
+  /// \param[in] _entity The entity, which must be in the grid
+  /// \param[in] _position The entity's position
+  /// \return true if the entity changed cells, false otherwise
+  public: bool Update(const Entity &_entity, const Vector3i &_position);
+
+  /// \brief Remove an entity from the grid
+  /// \param[in] _entity The entity. Nothing happens if it isn't in the grid
+  public: void Remove(const Entity &_entity);
+
+  /// \brief Call a function on every entity in the cells that overlap a box.
+  /// This includes entities that are outside of the box, but in one of its
+  /// cells, so the caller has to check positions
+  /// \param[in] _min The corner of the box with the lowest coordinates
+  /// \param[in] _max The corner of the box with the highest coordinates
+  /// (inclusive)
+  /// \param[in] _f The function, which is called with an entity and returns
+  /// false to stop
+  /// \return false if _f stopped the iteration, true otherwise
+  public: template<typename FunctionT>
+          bool EachCandidate(const Vector3i &_min, const Vector3i &_max,
+              const FunctionT &_f) const;
+
+  /// \brief Get the memory used by the grid
+  /// \return The number of bytes used by the grid's heap memory
+  public: std::size_t MemoryBytes() const;
+
+  /// \brief Get the cell coordinate of a position coordinate
+  /// \param[in] _coordinate The position coordinate
+  /// \return The cell coordinate (rounded towards negative infinity)
+  private: std::int64_t CellCoordinate(const int _coordinate) const;
+
+  /// \brief Get the key of a cell. Keys wrap around every 2^21 cells per
+  /// axis, so far away cells may share a key. That only adds candidates,
+  /// which the caller filters out
+  /// \param[in] _x The cell's x coordinate
+  /// \param[in] _y The cell's y coordinate
+  /// \param[in] _z The cell's z coordinate
+  /// \return The key
+  private: static std::uint64_t CellKey(const std::int64_t _x,
+               const std::int64_t _y, const std::int64_t _z);
+
+  /// \brief Get the key of the cell that contains a position
+  /// \param[in] _position The position
+  /// \return The key
+  private: std::uint64_t CellKeyOf(const Vector3i &_position) const;
+
+  /// \brief Where an entity is stored in the grid
+  private: struct Location
+  {
+    /// \brief The key of the entity's cell
+    std::uint64_t key;
+
+    /// \brief The index of the entity in its cell
+    std::size_t index;
+  };
+
+  /// \brief The number of bits of each cell coordinate in a cell key
+  private: constexpr const static int kKeyBits{21};
+
+  /// \brief The length of a cell's edge
+  private: int cellSize;
+
+  /// \brief The entities of every non-empty cell
+  private: std::unordered_map<std::uint64_t, std::vector<Entity>> cells;
+
+  /// \brief The location of every entity in the grid
+  private: std::unordered_map<Entity, Location> locations;
+};
+
+SpatialGrid::SpatialGrid(const int _cellSize)
+  : cellSize(_cellSize < 1 ? 1 : _cellSize)
+{
+}
+
+int SpatialGrid::CellSize() const
+{
+  return this->cellSize;
+}
+
+std::size_t SpatialGrid::Size() const
+{
+  return this->locations.size();
+}
+
+void SpatialGrid::Insert(const Entity &_entity, const Vector3i &_position)
+{
+  if (this->locations.find(_entity) != this->locations.end())
+    return;
+
+  const auto key = this->CellKeyOf(_position);
+  auto &cell = this->cells[key];
+  this->locations[_entity] = {key, cell.size()};
+  cell.push_back(_entity);
+}
+
+bool SpatialGrid::Update(const Entity &_entity, const Vector3i &_position)
+{
+  auto iter = this->locations.find(_entity);
+  if (iter == this->locations.end())
+    return false;
+
+  const auto key = this->CellKeyOf(_position);
+  if (iter->second.key == key)
+    return false;
+
+  this->Remove(_entity);
+  this->Insert(_entity, _position);
+  return true;
+}
+
+void SpatialGrid::Remove(const Entity &_entity)
+{
+  auto iter = this->locations.find(_entity);
+  if (iter == this->locations.end())
+    return;
+
+  // the last entity of the cell takes the removed entity's place
+  auto cellIter = this->cells.find(iter->second.key);
+  auto &cell = cellIter->second;
+  const auto index = iter->second.index;
+  if (index + 1 != cell.size())
+  {
+    cell[index] = cell.back();
+    this->locations[cell[index]].index = index;
+  }
+  cell.pop_back();
+  if (cell.empty())
+    this->cells.erase(cellIter);
+  this->locations.erase(iter);
+}
+
+template<typename FunctionT>
+bool SpatialGrid::EachCandidate(const Vector3i &_min, const Vector3i &_max,
+    const FunctionT &_f) const
+{
+  const std::int64_t minX = this->CellCoordinate(_min.x);
+  const std::int64_t minY = this->CellCoordinate(_min.y);
+  const std::int64_t minZ = this->CellCoordinate(_min.z);
+  const std::int64_t maxX = this->CellCoordinate(_max.x);
+  const std::int64_t maxY = this->CellCoordinate(_max.y);
+  const std::int64_t maxZ = this->CellCoordinate(_max.z);
+  if (maxX < minX || maxY < minY || maxZ < minZ)
+    return true;
+
+  // a box that covers more cells than are occupied (or so many cells that
+  // keys repeat) is cheaper to answer by going through the occupied cells
+  const std::int64_t kMaxSpan = std::int64_t{1} << kKeyBits;
+  const auto spanX = maxX - minX + 1;
+  const auto spanY = maxY - minY + 1;
+  const auto spanZ = maxZ - minZ + 1;
+  if (spanX >= kMaxSpan || spanY >= kMaxSpan || spanZ >= kMaxSpan ||
+      static_cast<double>(spanX) * spanY * spanZ >
+        static_cast<double>(this->cells.size()))
+  {
+    for (const auto &[key, cell] : this->cells)
+    {
+      for (const auto &entity : cell)
+      {
+        if (!_f(entity))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  for (auto z = minZ; z <= maxZ; ++z)
+  {
+    for (auto y = minY; y <= maxY; ++y)
+    {
+      for (auto x = minX; x <= maxX; ++x)
+      {
+        auto iter = this->cells.find(CellKey(x, y, z));
+        if (iter == this->cells.end())
+          continue;
+        for (const auto &entity : iter->second)
+        {
+          if (!_f(entity))
+            return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+std::size_t SpatialGrid::MemoryBytes() const
+{
+  auto bytes = UnorderedMemoryBytes(this->cells) +
+    UnorderedMemoryBytes(this->locations);
+  for (const auto &[key, cell] : this->cells)
+    bytes += VectorMemoryBytes(cell);
+  return bytes;
+}
+
+std::int64_t SpatialGrid::CellCoordinate(const int _coordinate) const
+{
+  // integer division rounds towards zero, but cells are numbered down from 0
+  // for negative coordinates
+  if (_coordinate >= 0)
+    return _coordinate / this->cellSize;
+  return -((-static_cast<std::int64_t>(_coordinate) - 1) / this->cellSize) - 1;
+}
+
+std::uint64_t SpatialGrid::CellKey(const std::int64_t _x,
+    const std::int64_t _y, const std::int64_t _z)
+{
+  const std::uint64_t mask = (std::uint64_t{1} << kKeyBits) - 1;
+  return (static_cast<std::uint64_t>(_x) & mask) |
+    ((static_cast<std::uint64_t>(_y) & mask) << kKeyBits) |
+    ((static_cast<std::uint64_t>(_z) & mask) << (2 * kKeyBits));
+}
+
+std::uint64_t SpatialGrid::CellKeyOf(const Vector3i &_position) const
+{
+  return CellKey(this->CellCoordinate(_position.x),
+      this->CellCoordinate(_position.y), this->CellCoordinate(_position.z));
+}
+
+#endif
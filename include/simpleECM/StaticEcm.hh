@@ -0,0 +1,463 @@
+#ifndef STATIC_ECM_HH_
+#define STATIC_ECM_HH_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simpleECM/ComponentMetadata.hh"
+#include "simpleECM/MemoryStats.hh"
+#include "simpleECM/Trace.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief Storage for the components of a single type in a StaticECM. The
+/// components are packed at the front of fixed size pages (a sparse set): a
+/// dense array holds the components and their entities, and a sparse array
+/// that is indexed by entity holds each entity's position in the dense array.
+/// Adding a component never moves the other components, but removing one
+/// moves the last component into its place. Tags (see IsTagComponent) only
+/// store their entities, and every entity shares a single instance
+template<typename ComponentTypeT>
+class StaticPool
+{
+  /// \brief Constructor
+  public: StaticPool();
+
+  /// \brief Destructor
+  public: ~StaticPool();
+
+  /// \brief Pools own raw memory, so they can't be copied
+  public: StaticPool(const StaticPool &) = delete;
+
+  /// \brief Pools own raw memory, so they can't be copied
+  public: StaticPool &operator=(const StaticPool &) = delete;
+
+  /// \brief Get the number of components in the pool
+  /// \return The number of components
+  public: std::size_t Size() const;
+
+  /// \brief Check if an entity has a component in the pool
+  /// \param[in] _entity The entity
+  /// \return true if _entity has a component in the pool, false otherwise
+  public: bool Has(const Entity &_entity) const;
+
+  /// \brief Get an entity's component
+  /// \param[in] _entity The entity
+  /// \return A pointer to _entity's component, or nullptr if _entity has no
+  /// component in the pool
+  public: ComponentTypeT *Component(const Entity &_entity) const;
+
+  /// \brief Copy a component into the pool. It is assumed that the entity does
+  /// not already have a component in the pool
+  /// \param[in] _entity The entity that owns the component
+  /// \param[in] _component The component to copy
+  public: void Add(const Entity &_entity, const ComponentTypeT &_component);
+
+  /// \brief Remove an entity's component from the pool, if it exists
+  /// \param[in] _entity The entity
+  public: void Remove(const Entity &_entity);
+
+  /// \brief Get the entity that owns a component
+  /// \param[in] _index The position of the component in the dense array,
+  /// which must be less than Size()
+  /// \return The entity
+  public: Entity DenseEntity(const std::size_t _index) const;
+
+  /// \brief Get a component by its position in the dense array
+  /// \param[in] _index The position, which must be less than Size()
+  /// \return The component
+  public: ComponentTypeT *DenseData(const std::size_t _index) const;
+
+  /// \brief Get the memory used by the pool
+  /// \return The pool's memory stats
+  public: ComponentMemoryStats MemoryStats() const;
+
+  /// \brief The number of components stored in a page
+  public: constexpr const static std::size_t kPageSize{1024};
+
+  /// \brief Whether the pool stores tags
+  private: constexpr const static bool kTag =
+             IsTagComponent<ComponentTypeT>::value;
+
+  /// \brief Used in the sparse array for entities without a component
+  private: constexpr const static std::uint32_t kNoIndex{
+             std::numeric_limits<std::uint32_t>::max()};
+
+  /// \brief The pages of component memory
+  private: std::vector<ComponentTypeT *> pages;
+
+  /// \brief The entity that owns each component, in dense array order
+  private: std::vector<Entity> entities;
+
+  /// \brief The position of every entity's component in the dense array
+  /// (kNoIndex for entities without a component)
+  private: std::vector<std::uint32_t> sparse;
+
+  /// \brief The instance that every entity shares, if the pool stores tags
+  private: std::unique_ptr<ComponentTypeT> tagInstance;
+};
+
+/// \brief An ECM whose component types are fixed at compile time. Each
+/// component type is stored in its own StaticPool, and the pools are kept in
+/// a tuple, so queries find their storage at compile time instead of through
+/// component type ids, hashed views or virtual calls. Each is answered
+/// without views: the smallest pool of the query drives the iteration, and
+/// the other components are found through the sparse arrays of their pools
+template<typename ...ComponentTypeTs>
+class StaticECM
+{
+  /// \brief Create an Entity
+  /// \return The Entity that was created
+  public: Entity CreateEntity();
+
+  /// \brief Get the number of entities that have been created
+  /// \return The number of entities
+  public: std::size_t EntityCount() const;
+
+  /// \brief Add a component to an entity (the entity must already exist)
+  /// \param[in] _entity The entity
+  /// \param[in] _component The component
+  public: template<typename ComponentTypeT>
+          void AddComponent(const Entity &_entity,
+              const ComponentTypeT &_component);
+
+  /// \brief Remove a component from an entity
+  /// \param[in] _entity The entity
+  public: template<typename ComponentTypeT>
+          void RemoveComponent(const Entity &_entity);
+
+  /// \brief Get an entity's component
+  /// \param[in] _entity The entity
+  /// \return The component, or nullptr if _entity doesn't have one
+  public: template<typename ComponentTypeT>
+          ComponentTypeT *Component(const Entity &_entity) const;
+
+  /// \brief Execute a callback function on each entity with a set of
+  /// components. The entity that is being visited may have components added
+  /// or removed by the callback; other changes made by the callback to the
+  /// component types of the query may cause entities to be skipped
+  /// \param[in] _f The callback function to be executed. Iteration stops if it
+  /// returns false
+  public: template<typename ...QueryTypeTs>
+          void Each(std::function<bool(const Entity &_entity,
+                                       QueryTypeTs*...)> _f);
+
+  /// \brief Get the memory used by the ECM
+  /// \return The ECM's memory stats (a StaticECM has no views)
+  public: EcmMemoryStats MemoryStats() const;
+
+  /// \brief Check at compile time that a component type is in the schema
+  private: template<typename ComponentTypeT>
+           constexpr static bool InSchema();
+
+  /// \brief Get the pool of a component type
+  /// \return The pool
+  private: template<typename ComponentTypeT>
+           StaticPool<ComponentTypeT> &Pool();
+
+  /// \brief Get the pool of a component type
+  /// \return The pool
+  private: template<typename ComponentTypeT>
+           const StaticPool<ComponentTypeT> &Pool() const;
+
+  /// \brief Iterate over the entities of one of the query's pools, looking
+  /// up the rest of the components
+  /// \param[in] _f The callback function to be executed
+  private: template<std::size_t DriverT, typename ...QueryTypeTs,
+                    std::size_t ...Indices>
+           void EachDrivenBy(const std::function<bool(const Entity &_entity,
+                                 QueryTypeTs*...)> &_f,
+               std::index_sequence<Indices...>);
+
+  /// \brief Pick the smallest of the query's pools and iterate over it
+  /// \param[in] _f The callback function to be executed
+  private: template<typename ...QueryTypeTs, std::size_t ...Indices>
+           void EachInPools(const std::function<bool(const Entity &_entity,
+                                QueryTypeTs*...)> &_f,
+               std::index_sequence<Indices...>);
+
+  /// \brief The pool of every component type
+  private: std::tuple<StaticPool<ComponentTypeTs>...> pools;
+
+  /// \brief The entity returned by the next CreateEntity call
+  private: Entity nextEntity{0};
+};
+
+template<typename ComponentTypeT>
+StaticPool<ComponentTypeT>::StaticPool()
+{
+  if constexpr (kTag)
+    this->tagInstance = std::make_unique<ComponentTypeT>();
+}
+
+template<typename ComponentTypeT>
+StaticPool<ComponentTypeT>::~StaticPool()
+{
+  if constexpr (!kTag)
+  {
+    for (std::size_t i = 0; i < this->Size(); ++i)
+      this->DenseData(i)->~ComponentTypeT();
+  }
+  for (auto page : this->pages)
+    ::operator delete(page, std::align_val_t{alignof(ComponentTypeT)});
+}
+
+template<typename ComponentTypeT>
+std::size_t StaticPool<ComponentTypeT>::Size() const
+{
+  return this->entities.size();
+}
+
+template<typename ComponentTypeT>
+bool StaticPool<ComponentTypeT>::Has(const Entity &_entity) const
+{
+  return _entity < this->sparse.size() && this->sparse[_entity] != kNoIndex;
+}
+
+template<typename ComponentTypeT>
+ComponentTypeT *StaticPool<ComponentTypeT>::Component(
+    const Entity &_entity) const
+{
+  if (!this->Has(_entity))
+    return nullptr;
+  return this->DenseData(this->sparse[_entity]);
+}
+
+template<typename ComponentTypeT>
+void StaticPool<ComponentTypeT>::Add(const Entity &_entity,
+    const ComponentTypeT &_component)
+{
+  const auto index = this->Size();
+  if constexpr (!kTag)
+  {
+    if (index == this->pages.size() * kPageSize)
+    {
+      this->pages.push_back(static_cast<ComponentTypeT *>(::operator new(
+              kPageSize * sizeof(ComponentTypeT),
+              std::align_val_t{alignof(ComponentTypeT)})));
+    }
+    new (this->DenseData(index)) ComponentTypeT(_component);
+  }
+
+  this->entities.push_back(_entity);
+  if (_entity >= this->sparse.size())
+    this->sparse.resize(_entity + 1, kNoIndex);
+  this->sparse[_entity] = static_cast<std::uint32_t>(index);
+}
+
+template<typename ComponentTypeT>
+void StaticPool<ComponentTypeT>::Remove(const Entity &_entity)
+{
+  if (!this->Has(_entity))
+    return;
+
+  // the last component takes the removed component's place
+  const auto index = this->sparse[_entity];
+  const auto last = this->Size() - 1;
+  if constexpr (!kTag)
+  {
+    auto removed = this->DenseData(index);
+    removed->~ComponentTypeT();
+    if (index != last)
+    {
+      auto moved = this->DenseData(last);
+      new (removed) ComponentTypeT(std::move(*moved));
+      moved->~ComponentTypeT();
+    }
+  }
+  if (index != last)
+  {
+    this->entities[index] = this->entities[last];
+    this->sparse[this->entities[index]] = index;
+  }
+  this->entities.pop_back();
+  this->sparse[_entity] = kNoIndex;
+}
+
+template<typename ComponentTypeT>
+Entity StaticPool<ComponentTypeT>::DenseEntity(const std::size_t _index) const
+{
+  return this->entities[_index];
+}
+
+template<typename ComponentTypeT>
+ComponentTypeT *StaticPool<ComponentTypeT>::DenseData(
+    const std::size_t _index) const
+{
+  if constexpr (kTag)
+    return this->tagInstance.get();
+  else
+    return this->pages[_index / kPageSize] + _index % kPageSize;
+}
+
+template<typename ComponentTypeT>
+ComponentMemoryStats StaticPool<ComponentTypeT>::MemoryStats() const
+{
+  ComponentMemoryStats stats;
+  stats.typeId = ComponentTypeT::typeId;
+  stats.name = ComponentTypeT::typeName;
+  stats.count = this->Size();
+  stats.dataBytes = kTag ? sizeof(ComponentTypeT) :
+    this->Size() * sizeof(ComponentTypeT);
+  stats.slackBytes =
+    (this->pages.size() * kPageSize - (kTag ? 0 : this->Size())) *
+    sizeof(ComponentTypeT);
+  stats.indexBytes = VectorMemoryBytes(this->pages) +
+    VectorMemoryBytes(this->entities) + VectorMemoryBytes(this->sparse);
+  return stats;
+}
+
+template<typename ...ComponentTypeTs>
+Entity StaticECM<ComponentTypeTs...>::CreateEntity()
+{
+  return this->nextEntity++;
+}
+
+template<typename ...ComponentTypeTs>
+std::size_t StaticECM<ComponentTypeTs...>::EntityCount() const
+{
+  return this->nextEntity;
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+void StaticECM<ComponentTypeTs...>::AddComponent(const Entity &_entity,
+    const ComponentTypeT &_component)
+{
+  static_assert(InSchema<ComponentTypeT>(),
+      "The component type isn't part of the StaticECM's schema");
+  auto &pool = this->Pool<ComponentTypeT>();
+  if (_entity >= this->nextEntity || pool.Has(_entity))
+    return;
+  pool.Add(_entity, _component);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+void StaticECM<ComponentTypeTs...>::RemoveComponent(const Entity &_entity)
+{
+  static_assert(InSchema<ComponentTypeT>(),
+      "The component type isn't part of the StaticECM's schema");
+  this->Pool<ComponentTypeT>().Remove(_entity);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+ComponentTypeT *StaticECM<ComponentTypeTs...>::Component(
+    const Entity &_entity) const
+{
+  static_assert(InSchema<ComponentTypeT>(),
+      "The component type isn't part of the StaticECM's schema");
+  return this->Pool<ComponentTypeT>().Component(_entity);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ...QueryTypeTs>
+void StaticECM<ComponentTypeTs...>::Each(
+    std::function<bool(const Entity &_entity, QueryTypeTs*...)> _f)
+{
+  static_assert(sizeof...(QueryTypeTs) > 0,
+      "Each needs at least one component type");
+  static_assert((... && InSchema<QueryTypeTs>()),
+      "A component type isn't part of the StaticECM's schema");
+  SIMPLE_ECM_TRACE_SCOPE("StaticECM::Each");
+  this->EachInPools<QueryTypeTs...>(_f,
+      std::index_sequence_for<QueryTypeTs...>());
+}
+
+template<typename ...ComponentTypeTs>
+EcmMemoryStats StaticECM<ComponentTypeTs...>::MemoryStats() const
+{
+  EcmMemoryStats stats;
+  stats.entities = this->nextEntity;
+  stats.components = {this->Pool<ComponentTypeTs>().MemoryStats()...};
+  return stats;
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+constexpr bool StaticECM<ComponentTypeTs...>::InSchema()
+{
+  return (... || std::is_same_v<ComponentTypeT, ComponentTypeTs>);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+StaticPool<ComponentTypeT> &StaticECM<ComponentTypeTs...>::Pool()
+{
+  return std::get<StaticPool<ComponentTypeT>>(this->pools);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ComponentTypeT>
+const StaticPool<ComponentTypeT> &StaticECM<ComponentTypeTs...>::Pool() const
+{
+  return std::get<StaticPool<ComponentTypeT>>(this->pools);
+}
+
+template<typename ...ComponentTypeTs>
+template<typename ...QueryTypeTs, std::size_t ...Indices>
+void StaticECM<ComponentTypeTs...>::EachInPools(
+    const std::function<bool(const Entity &_entity, QueryTypeTs*...)> &_f,
+    std::index_sequence<Indices...>)
+{
+  // every entity that matches the query is in the smallest pool
+  const std::array<std::size_t, sizeof...(QueryTypeTs)> sizes{
+    this->Pool<QueryTypeTs>().Size()...};
+  const auto driver = static_cast<std::size_t>(
+      std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+
+  // the driver is only known at runtime, so a loop is instantiated for each
+  // of the query's pools
+  static_cast<void>((... || (Indices == driver &&
+          (this->EachDrivenBy<Indices, QueryTypeTs...>(_f,
+              std::index_sequence_for<QueryTypeTs...>()), true))));
+}
+
+template<typename ...ComponentTypeTs>
+template<std::size_t DriverT, typename ...QueryTypeTs,
+         std::size_t ...Indices>
+void StaticECM<ComponentTypeTs...>::EachDrivenBy(
+    const std::function<bool(const Entity &_entity, QueryTypeTs*...)> &_f,
+    std::index_sequence<Indices...>)
+{
+  using DriverType =
+    std::tuple_element_t<DriverT, std::tuple<QueryTypeTs...>>;
+  const auto &driverPool = this->Pool<DriverType>();
+
+  // the dense array is walked from the back, so that removing the visited
+  // entity's components only moves components that were already visited
+  for (auto index = driverPool.Size(); index-- > 0;)
+  {
+    if (index >= driverPool.Size())
+      continue;
+
+    const auto entity = driverPool.DenseEntity(index);
+    const std::tuple<QueryTypeTs*...> components{[&]()
+        {
+          if constexpr (Indices == DriverT)
+          {
+            return driverPool.DenseData(index);
+          }
+          else
+          {
+            return this->Pool<QueryTypeTs>().Component(entity);
+          }
+        }()...};
+    if (!(... && std::get<Indices>(components)))
+      continue;
+    if (!_f(entity, std::get<Indices>(components)...))
+      return;
+  }
+}
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef TRACE_HH_
+#define TRACE_HH_
+
+// Tracing is only compiled in if _SIMPLE_ECM_TRACING is defined (see the
+// ENABLE_TRACING cmake option). Otherwise, the trace macros below expand to
+// nothing, so trace points have no cost.
+//
+// Trace points:
+//  * SIMPLE_ECM_TRACE_SCOPE(name) records the time spent in the enclosing
+//    scope. name must be a string literal
+//  * SIMPLE_ECM_TRACE_COUNT(name) increments a named counter. name must be a
+//    string literal
+//
+// Scopes are recorded in a fixed size ring buffer that belongs to the thread
+// that recorded them (the oldest events are overwritten once a buffer is
+// full), so recording an event never takes a lock.
+
+#ifdef _SIMPLE_ECM_TRACING
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// \brief A scope that was recorded by a trace point
+struct TraceEvent
+{
+  /// \brief The name of the trace point
+  const char *name;
+
+  /// \brief When the scope started, in nanoseconds since the first event
+  std::int64_t startNs;
+
+  /// \brief How long the scope took, in nanoseconds
+  std::int64_t durationNs;
+};
+
+/// \brief A fixed size ring buffer of events that were recorded by a thread
+struct TraceBuffer
+{
+  /// \brief The number of events a buffer holds before overwriting old events
+  constexpr const static std::size_t kCapacity{1 << 16};
+
+  /// \brief An ID for the thread that owns the buffer
+  std::size_t threadId{0};
+
+  /// \brief The total number of events that have been recorded. The newest
+  /// event is at index (count - 1) % kCapacity
+  std::atomic<std::size_t> count{0};
+
+  /// \brief The recorded events
+  std::array<TraceEvent, kCapacity> events;
+};
+
+class Trace
+{
+  /// \brief Get the current time on the trace clock
+  /// \return Nanoseconds since the trace clock started
+  public: static std::int64_t NowNs();
+
+  /// \brief Record a completed scope in the calling thread's buffer
+  /// \param[in] _name The name of the trace point
+  /// \param[in] _startNs When the scope started (see NowNs)
+  /// \param[in] _endNs When the scope ended (see NowNs)
+  public: static void Record(const char *_name, const std::int64_t _startNs,
+              const std::int64_t _endNs);
+
+  /// \brief Get a named counter, creating it if needed. The counter's address
+  /// never changes, so trace points can look it up once and cache it
+  /// \param[in] _name The name of the counter
+  /// \return The counter
+  public: static std::atomic<std::uint64_t> &Counter(const char *_name);
+
+  /// \brief Get the current value of every counter
+  /// \return A map of counter name to value
+  public: static std::map<std::string, std::uint64_t> Counters();
+
+  /// \brief Write all of the recorded events and the current counter values
+  /// in the Chrome trace event format, which can be loaded in
+  /// chrome://tracing or https://ui.perfetto.dev. This should be called while
+  /// no other thread is recording events
+  /// \param[in] _os The stream to write to
+  public: static void WriteChromeTrace(std::ostream &_os);
+
+  /// \brief Discard all recorded events and reset all counters to 0. This
+  /// should be called while no other thread is recording events
+  public: static void Clear();
+
+  /// \brief Get the calling thread's buffer, creating it if needed
+  /// \return The buffer
+  private: static TraceBuffer &ThreadBuffer();
+
+  /// \brief The shared state of all threads that record events
+  private: struct State
+  {
+    /// \brief Protects buffers and counters (but not the buffer contents)
+    std::mutex mutex;
+
+    /// \brief The buffer of every thread that has recorded an event
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+    /// \brief The counters, by name
+    std::map<std::string, std::unique_ptr<std::atomic<std::uint64_t>>>
+      counters;
+
+    /// \brief When the trace clock started
+    std::chrono::steady_clock::time_point epoch{
+      std::chrono::steady_clock::now()};
+  };
+
+  /// \brief Get the shared state
+  /// \return The shared state
+  private: static State &SharedState();
+};
+
+/// \brief Records the time between its construction and destruction
+class TraceScope
+{
+  /// \brief Constructor
+  /// \param[in] _name The name of the trace point
+  public: explicit TraceScope(const char *_name)
+    : name(_name), startNs(Trace::NowNs())
+  {
+  }
+
+  /// \brief Destructor, which records the scope
+  public: ~TraceScope()
+  {
+    Trace::Record(this->name, this->startNs, Trace::NowNs());
+  }
+
+  /// \brief The name of the trace point
+  private: const char *name;
+
+  /// \brief When the scope started
+  private: std::int64_t startNs;
+};
+
+std::int64_t Trace::NowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - SharedState().epoch).count();
+}
+
+void Trace::Record(const char *_name, const std::int64_t _startNs,
+    const std::int64_t _endNs)
+{
+  auto &buffer = ThreadBuffer();
+  const auto count = buffer.count.load(std::memory_order_relaxed);
+  buffer.events[count % TraceBuffer::kCapacity] =
+    {_name, _startNs, _endNs - _startNs};
+  buffer.count.store(count + 1, std::memory_order_release);
+}
+
+std::atomic<std::uint64_t> &Trace::Counter(const char *_name)
+{
+  auto &state = SharedState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  auto &counter = state.counters[_name];
+  if (!counter)
+    counter = std::make_unique<std::atomic<std::uint64_t>>(0);
+  return *counter;
+}
+
+std::map<std::string, std::uint64_t> Trace::Counters()
+{
+  auto &state = SharedState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  std::map<std::string, std::uint64_t> values;
+  for (const auto &[name, counter] : state.counters)
+    values[name] = counter->load(std::memory_order_relaxed);
+  return values;
+}
+
+void Trace::WriteChromeTrace(std::ostream &_os)
+{
+  auto &state = SharedState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+
+  // the Chrome trace format uses microseconds
+  _os << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+  bool first = true;
+  for (const auto &buffer : state.buffers)
+  {
+    const auto count = buffer->count.load(std::memory_order_acquire);
+    const auto numEvents = std::min(count, TraceBuffer::kCapacity);
+    for (auto i = count - numEvents; i < count; ++i)
+    {
+      const auto &event = buffer->events[i % TraceBuffer::kCapacity];
+      _os << (first ? "\n" : ",\n")
+        << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0"
+        << ", \"tid\": " << buffer->threadId
+        << ", \"ts\": " << event.startNs / 1000.0
+        << ", \"dur\": " << event.durationNs / 1000.0 << "}";
+      first = false;
+    }
+  }
+
+  const auto endUs = NowNs() / 1000.0;
+  for (const auto &[name, counter] : state.counters)
+  {
+    _os << (first ? "\n" : ",\n")
+      << "{\"name\": \"" << name << "\", \"ph\": \"C\", \"pid\": 0"
+      << ", \"ts\": " << endUs << ", \"args\": {\"value\": "
+      << counter->load(std::memory_order_relaxed) << "}}";
+    first = false;
+  }
+  _os << "\n]}\n" << std::defaultfloat;
+}
+
+void Trace::Clear()
+{
+  auto &state = SharedState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  for (auto &buffer : state.buffers)
+    buffer->count.store(0, std::memory_order_relaxed);
+  for (auto &[name, counter] : state.counters)
+    counter->store(0, std::memory_order_relaxed);
+}
+
+TraceBuffer &Trace::ThreadBuffer()
+{
+  thread_local TraceBuffer *buffer = nullptr;
+  if (!buffer)
+  {
+    auto &state = SharedState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.buffers.push_back(std::make_unique<TraceBuffer>());
+    buffer = state.buffers.back().get();
+    buffer->threadId = state.buffers.size() - 1;
+  }
+  return *buffer;
+}
+
+Trace::State &Trace::SharedState()
+{
+  static State state;
+  return state;
+}
+
+#define SIMPLE_ECM_TRACE_CONCAT_IMPL(_a, _b) _a##_b
+#define SIMPLE_ECM_TRACE_CONCAT(_a, _b) SIMPLE_ECM_TRACE_CONCAT_IMPL(_a, _b)
+
+#define SIMPLE_ECM_TRACE_SCOPE(_name) \
+  TraceScope SIMPLE_ECM_TRACE_CONCAT(traceScope, __LINE__)(_name)
+
+#define SIMPLE_ECM_TRACE_COUNT(_name) \
+  do \
+  { \
+    static auto &traceCounter = Trace::Counter(_name); \
+    traceCounter.fetch_add(1, std::memory_order_relaxed); \
+  } while (false)
+
+#else
+
+#define SIMPLE_ECM_TRACE_SCOPE(_name)
+#define SIMPLE_ECM_TRACE_COUNT(_name) do {} while (false)
+
+#endif // _SIMPLE_ECM_TRACING
+
+#endif
@@ -1,12 +1,17 @@
 #ifndef TYPES_HH_
 #define TYPES_HH_
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <ostream>
 
 /// \brief An entity, which can have 0 or more components
 using Entity = std::uint64_t;
 
+/// \brief An invalid entity
+const Entity kNullEntity{std::numeric_limits<Entity>::max()};
+
 /// \brief An identifier that specifies a component type
 using ComponentTypeId = std::uint64_t;
 
@@ -50,4 +55,79 @@ struct Quaternion
 /// \brief A quaternion of integers
 typedef Quaternion<int> Quaternioni;
 
+/// \brief A non-owning view of a contiguous array of objects
+template<typename T>
+class Span
+{
+  /// \brief Constructor for an empty span
+  public: Span() = default;
+
+  /// \brief Constructor
+  /// \param[in] _data The first object
+  /// \param[in] _size The number of objects
+  public: Span(T *_data, const std::size_t _size)
+    : ptr(_data), count(_size)
+  {
+  }
+
+  /// \brief Get the first object
+  /// \return A pointer to the first object
+  public: T *data() const
+  {
+    return this->ptr;
+  }
+
+  /// \brief Get the number of objects
+  /// \return The number of objects
+  public: std::size_t size() const
+  {
+    return this->count;
+  }
+
+  /// \brief Check if the span is empty
+  /// \return true if the span has no objects, false otherwise
+  public: bool empty() const
+  {
+    return this->count == 0;
+  }
+
+  /// \brief Get an object
+  /// \param[in] _index The index of the object, which must be less than size()
+  /// \return The object
+  public: T &operator[](const std::size_t _index) const
+  {
+    return this->ptr[_index];
+  }
+
+  /// \brief Get an iterator to the first object
+  /// \return The iterator
+  public: T *begin() const
+  {
+    return this->ptr;
+  }
+
+  /// \brief Get an iterator past the last object
+  /// \return The iterator
+  public: T *end() const
+  {
+    return this->ptr + this->count;
+  }
+
+  /// \brief The first object
+  private: T *ptr{nullptr};
+
+  /// \brief The number of objects
+  private: std::size_t count{0};
+};
+
+/// \brief Move a pointer by a number of bytes
+/// \param[in] _ptr The pointer
+/// \param[in] _bytes The number of bytes to move the pointer by
+/// \return The moved pointer
+template<typename T>
+T *OffsetPointer(T *_ptr, const std::ptrdiff_t _bytes)
+{
+  return reinterpret_cast<T *>(reinterpret_cast<std::uintptr_t>(_ptr) + _bytes);
+}
+
 #endif
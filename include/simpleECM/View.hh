@@ -1,28 +1,77 @@
 #ifndef VIEW_HH_
 #define VIEW_HH_
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "simpleECM/HugePages.hh"
+#include "simpleECM/MemoryStats.hh"
 #include "simpleECM/Types.hh"
 
+/// \brief How often a view is used and how much memory it takes up, which
+/// helps decide which views are worth keeping
+struct ViewUsageStats
+{
+  /// \brief The component types of the view, in view order
+  std::vector<ComponentTypeId> componentTypes;
+
+  /// \brief The names of the component types of the view, in view order
+  std::string name;
+
+  /// \brief Whether the view currently exists (it may have been destroyed or
+  /// evicted)
+  bool alive{false};
+
+  /// \brief The number of times the view was requested (by Each, for example)
+  std::uint64_t useCount{0};
+
+  /// \brief When the view was last requested. This is a sequence number that
+  /// is shared by all views of an ECM, so a larger number means more recent use
+  std::uint64_t lastUse{0};
+
+  /// \brief The number of times the view had to be built from scratch
+  std::uint64_t buildCount{0};
+
+  /// \brief The number of times the view was evicted to meet the ECM's view
+  /// memory budget
+  std::uint64_t evictionCount{0};
+
+  /// \brief The number of entities in the view (0 if the view doesn't exist)
+  std::size_t rows{0};
+
+  /// \brief The bytes used by the view (0 if the view doesn't exist)
+  std::size_t bytes{0};
+};
+
+/// \brief A function that finds an entity's component of a particular type.
+/// nullptr should be returned if the entity has no component of that type
+using ComponentLookup =
+  std::function<void *(const Entity &_entity, const ComponentTypeId &_typeId)>;
+
 class BaseView
 {
-  /// \brief Get the entities that are stored in the view
-  /// \return The entities in the view
-  public: std::unordered_set<Entity> Entities() const
-  {
-    return this->entities;
-  }
+  /// \brief Get the number of entities (rows) in the view
+  /// \return The number of entities in the view
+  public: virtual std::size_t EntityCount() const = 0;
 
   /// \brief Check if an entity is a part of the view
   /// \param[in] _entity The entity
   /// \return true if _entity is a part of the view, false otherwise
-  public: bool HasEntity(const Entity &_entity) const
-  {
-    return this->entities.find(_entity) != this->entities.end();
-  }
+  public: virtual bool HasEntity(const Entity &_entity) const = 0;
+
+  /// \brief Get the entities in the view, in row order
+  /// \return The entities
+  public: virtual std::vector<Entity> RowEntities() const = 0;
 
   /// \brief Check if an entity is marked as an entity to be added to the view
   /// \param[in] _entity The entity
@@ -37,6 +86,29 @@ class BaseView
   /// \param[in] _entity The entity
   public: virtual void RemoveEntity(const Entity &_entity) = 0;
 
+  /// \brief Add an entity to the view right away, instead of waiting until
+  /// the next time the view is used. It is assumed that the entity has all of
+  /// the view's components and isn't already associated with the view
+  /// \param[in] _entity The entity
+  /// \param[in] _lookup Used to find the entity's component data
+  public: virtual void AddEntity(const Entity &_entity,
+              const ComponentLookup &_lookup) = 0;
+
+  /// \brief Look up the component data of every entity in the view again,
+  /// which must be done after components are moved in memory. The rows are
+  /// then sorted by the address of their first component, so iterating over
+  /// the view walks through that component's storage in order
+  /// \param[in] _lookup Used to find the entities' component data
+  public: virtual void Relink(const ComponentLookup &_lookup) = 0;
+
+  /// \brief Look up the component data of a single entity again, which must
+  /// be done after any of the entity's components are moved in memory.
+  /// Nothing happens if the entity isn't in the view
+  /// \param[in] _entity The entity
+  /// \param[in] _lookup Used to find the entity's component data
+  public: virtual void RelinkEntity(const Entity &_entity,
+              const ComponentLookup &_lookup) = 0;
+
   /// \brief Get all of the new entities that should be added to the view
   /// \return The entities
   public: std::unordered_set<Entity> NewEntities() const
@@ -44,6 +116,13 @@ class BaseView
     return this->newEntities;
   }
 
+  /// \brief Check if there are new entities that should be added to the view
+  /// \return true if there are new entities, false otherwise
+  public: bool HasNewEntities() const
+  {
+    return !this->newEntities.empty();
+  }
+
   /// \brief Add a new entity to the view. This entity's component data should
   /// be added to the view the next time the view is being used. It is assumed
   /// that this new entity isn't already associated with the view
@@ -70,6 +149,55 @@ class BaseView
     return this->compTypes.find(_typeId) != this->compTypes.end();
   }
 
+  /// \brief Mark the view as registered (or not). Entities are added to a
+  /// registered view as soon as they have all of the view's components, and
+  /// registered views are never evicted
+  /// \param[in] _registered Whether the view is registered
+  public: void SetRegistered(const bool _registered)
+  {
+    this->registered = _registered;
+  }
+
+  /// \brief Check if the view is registered
+  /// \return true if the view is registered, false otherwise
+  /// \sa SetRegistered
+  public: bool Registered() const
+  {
+    return this->registered;
+  }
+
+  /// \brief Mark the view as being in use, which keeps it from being
+  /// destroyed or evicted. Each call must be matched by a call to Unpin
+  /// \sa ViewPin
+  public: void Pin()
+  {
+    this->pinCount++;
+  }
+
+  /// \brief Undo a call to Pin
+  public: void Unpin()
+  {
+    this->pinCount--;
+  }
+
+  /// \brief Check if the view is in use
+  /// \return true if the view is pinned, false otherwise
+  public: bool Pinned() const
+  {
+    return this->pinCount > 0;
+  }
+
+  /// \brief Store the view's rows in huge page mappings once they're large
+  /// enough (see HugePageAllocator), or on the heap again. The rows are
+  /// copied, but the component pointers in them don't change
+  /// \param[in] _hugePages Whether the rows should use huge pages
+  public: virtual void SetHugePages(const bool _hugePages) = 0;
+
+  /// \brief Get the memory used by the view. The component types of the
+  /// returned stats are left for the caller to fill in
+  /// \return The view's memory stats
+  public: virtual ViewMemoryStats MemoryStats() const = 0;
+
   /// \brief Destructor
   public: virtual ~BaseView()
   {
@@ -78,17 +206,65 @@ class BaseView
   /// \brief New entities to be added to the view
   protected: std::unordered_set<Entity> newEntities;
 
-  /// \brief The entities in the view
-  protected: std::unordered_set<Entity> entities;
-
   /// \brief The component types in the view
   protected: std::unordered_set<ComponentTypeId> compTypes;
+
+  /// \brief The number of unmatched Pin calls
+  private: std::size_t pinCount{0};
+
+  /// \brief Whether the view is registered
+  private: bool registered{false};
+};
+
+/// \brief Pins a view for as long as the ViewPin exists
+class ViewPin
+{
+  /// \brief Constructor
+  /// \param[in] _view The view to pin
+  public: explicit ViewPin(BaseView *_view)
+    : view(_view)
+  {
+    this->view->Pin();
+  }
+
+  /// \brief A ViewPin can't be copied, since that would unpin twice
+  public: ViewPin(const ViewPin &) = delete;
+
+  /// \brief A ViewPin can't be copied, since that would unpin twice
+  public: ViewPin &operator=(const ViewPin &) = delete;
+
+  /// \brief Destructor, which unpins the view
+  public: ~ViewPin()
+  {
+    this->view->Unpin();
+  }
+
+  /// \brief The pinned view
+  private: BaseView *view;
 };
 
 template<typename ...ComponentTypeTs>
 class View : public BaseView
 {
-  private: using ComponentData = std::tuple<Entity, ComponentTypeTs*...>;
+  /// \brief A row of the view: an entity and pointers to its components
+  public: using ComponentData = std::tuple<Entity, ComponentTypeTs*...>;
+
+  /// \brief A copy of the components of a row, which is what packed views
+  /// store (see SetPacked)
+  public: using PackedData = std::tuple<ComponentTypeTs...>;
+
+  /// \brief The storage of the rows
+  public: using RowVector =
+            std::vector<ComponentData, HugePageAllocator<ComponentData>>;
+
+  /// \brief The storage of the packed copies of the rows
+  public: using PackedVector =
+            std::vector<PackedData, HugePageAllocator<PackedData>>;
+
+  /// \brief The offset from the component pointers stored in the view to the
+  /// components that are copied, per component type
+  public: using Offsets =
+            std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)>;
 
   /// \brief Constructor
   public: View()
@@ -100,9 +276,58 @@ class View : public BaseView
   /// entity being requested exists in the view
   /// \param[in] _entity The entity
   /// \return The entity and its component data
-  public: ComponentData EntityComponentData(const Entity &_entity) const
+  public: const ComponentData &EntityComponentData(const Entity &_entity) const
+  {
+    return this->rows[this->rowIndices.at(_entity)];
+  }
+
+  /// \brief Find an entity's row
+  /// \param[in] _entity The entity
+  /// \return The entity and its component data, or nullptr if the entity
+  /// isn't in the view
+  public: const ComponentData *FindRow(const Entity &_entity) const
+  {
+    auto iter = this->rowIndices.find(_entity);
+    if (iter == this->rowIndices.end())
+      return nullptr;
+    return &this->rows[iter->second];
+  }
+
+  /// \brief Get a row of the view
+  /// \param[in] _row The row, which must be less than EntityCount()
+  /// \return The row's entity and its component data
+  public: const ComponentData &Row(const std::size_t _row) const
+  {
+    return this->rows[_row];
+  }
+
+  /// \brief Get all of the rows of the view
+  /// \return The rows
+  public: const RowVector &Rows() const
+  {
+    return this->rows;
+  }
+
+  /// \brief Documentation inherited
+  public: std::size_t EntityCount() const
+  {
+    return this->rows.size();
+  }
+
+  /// \brief Documentation inherited
+  public: bool HasEntity(const Entity &_entity) const
   {
-    return this->data.at(_entity);
+    return this->rowIndices.find(_entity) != this->rowIndices.end();
+  }
+
+  /// \brief Documentation inherited
+  public: std::vector<Entity> RowEntities() const
+  {
+    std::vector<Entity> rowEntities;
+    rowEntities.reserve(this->rows.size());
+    for (const auto &row : this->rows)
+      rowEntities.push_back(std::get<0>(row));
+    return rowEntities;
   }
 
   /// \brief Add an entity with its component data to the view. It is assunmed
@@ -111,20 +336,335 @@ class View : public BaseView
   /// \param[in] _compPtrs Pointers to the entity's components
   public: void AddEntity(const Entity &_entity, ComponentTypeTs*... _compPtrs)
   {
-    this->data[_entity] = std::make_tuple(_entity, _compPtrs...);
-    this->entities.insert(_entity);
+    this->rowIndices[_entity] = this->rows.size();
+    this->rows.emplace_back(_entity, _compPtrs...);
+  }
+
+  /// \brief Documentation inherited
+  public: void AddEntity(const Entity &_entity,
+              const ComponentLookup &_lookup)
+  {
+    this->AddEntity(_entity, static_cast<ComponentTypeTs*>(
+          _lookup(_entity, ComponentTypeTs::typeId))...);
   }
 
   /// \brief Documentation inherited
   public: void RemoveEntity(const Entity &_entity)
   {
     this->newEntities.erase(_entity);
-    this->entities.erase(_entity);
-    this->data.erase(_entity);
+
+    // move the last row into the removed entity's row, so rows stay packed
+    auto iter = this->rowIndices.find(_entity);
+    if (iter == this->rowIndices.end())
+      return;
+    const auto row = iter->second;
+    this->rowIndices.erase(iter);
+    if (row != this->rows.size() - 1)
+    {
+      this->rows[row] = this->rows.back();
+      this->rowIndices[std::get<0>(this->rows[row])] = row;
+    }
+    this->rows.pop_back();
+  }
+
+  /// \brief Documentation inherited
+  public: void Relink(const ComponentLookup &_lookup)
+  {
+    for (auto &row : this->rows)
+    {
+      const auto entity = std::get<0>(row);
+      row = ComponentData(entity, static_cast<ComponentTypeTs*>(
+            _lookup(entity, ComponentTypeTs::typeId))...);
+    }
+
+    std::sort(this->rows.begin(), this->rows.end(),
+        [](const ComponentData &_a, const ComponentData &_b)
+        {
+          return std::less<const void *>()(std::get<1>(_a), std::get<1>(_b));
+        });
+    for (std::size_t row = 0; row < this->rows.size(); ++row)
+      this->rowIndices[std::get<0>(this->rows[row])] = row;
+  }
+
+  /// \brief Documentation inherited
+  public: void RelinkEntity(const Entity &_entity,
+              const ComponentLookup &_lookup)
+  {
+    auto iter = this->rowIndices.find(_entity);
+    if (iter == this->rowIndices.end())
+      return;
+    this->rows[iter->second] = ComponentData(_entity,
+        static_cast<ComponentTypeTs*>(
+          _lookup(_entity, ComponentTypeTs::typeId))...);
+  }
+
+  /// \brief Make the view keep copies of its rows' components in a single
+  /// contiguous buffer (or stop doing so, which releases the buffer). The
+  /// copies are made by Pack and written back by Unpack
+  /// \param[in] _packed Whether the view should be packed
+  public: void SetPacked(const bool _packed)
+  {
+    this->packed = _packed;
+    if (!_packed)
+      PackedVector(this->packedRows.get_allocator()).swap(this->packedRows);
+  }
+
+  /// \brief Check if the view is packed
+  /// \return true if the view is packed, false otherwise
+  /// \sa SetPacked
+  public: bool Packed() const
+  {
+    return this->packed;
+  }
+
+  /// \brief Copy the components of every row into the packed buffer, in row
+  /// order
+  /// \param[in] _offsets The offset from each stored component pointer to
+  /// the component that should be copied
+  /// \return The packed copies, one per row
+  public: PackedVector &Pack(const Offsets &_offsets)
+  {
+    this->packedRows.resize(this->rows.size());
+    this->CopyRows(_offsets, this->rows.size(), true,
+        std::index_sequence_for<ComponentTypeTs...>());
+    return this->packedRows;
+  }
+
+  /// \brief Write the packed copies of the first rows back to the
+  /// components they were copied from. The rows must not have changed since
+  /// Pack was called
+  /// \param[in] _offsets The offsets that were given to Pack
+  /// \param[in] _end The row after the last row to write back
+  public: void Unpack(const Offsets &_offsets, const std::size_t _end)
+  {
+    this->CopyRows(_offsets, _end, false,
+        std::index_sequence_for<ComponentTypeTs...>());
+  }
+
+  /// \brief Documentation inherited
+  public: void SetHugePages(const bool _hugePages)
+  {
+    HugePageAllocator<ComponentData> allocator(_hugePages);
+    if (allocator == this->rows.get_allocator())
+      return;
+
+    // the allocators are moved along with the new vectors
+    this->rows = RowVector(this->rows.begin(), this->rows.end(), allocator);
+    this->packedRows = PackedVector(this->packedRows.begin(),
+        this->packedRows.end(), HugePageAllocator<PackedData>(allocator));
+  }
+
+  /// \brief Documentation inherited
+  public: ViewMemoryStats MemoryStats() const
+  {
+    ViewMemoryStats stats;
+    stats.rows = this->rows.size();
+    stats.rowBytes = this->rows.size() * sizeof(ComponentData);
+    stats.slackBytes = VectorMemoryBytes(this->rows) - stats.rowBytes;
+    if (this->packed)
+    {
+      const auto packedBytes = this->packedRows.size() * sizeof(PackedData);
+      stats.rowBytes += packedBytes;
+      stats.slackBytes += VectorMemoryBytes(this->packedRows) - packedBytes;
+    }
+    stats.indexBytes = UnorderedMemoryBytes(this->rowIndices) +
+      UnorderedMemoryBytes(this->newEntities) +
+      UnorderedMemoryBytes(this->compTypes);
+    stats.hugePageBytes =
+      this->rows.get_allocator().HugePageBytes(this->rows.capacity()) +
+      this->packedRows.get_allocator().HugePageBytes(
+          this->packedRows.capacity());
+    return stats;
+  }
+
+  /// \brief Copy components between the first rows and their packed copies
+  /// \param[in] _offsets The offset from each stored component pointer to
+  /// the component that is copied
+  /// \param[in] _end The row after the last row to copy
+  /// \param[in] _pack true to copy the components into the packed copies,
+  /// false to copy the packed copies back to the components
+  private: template<std::size_t ...Indices>
+           void CopyRows(const Offsets &_offsets, const std::size_t _end,
+               const bool _pack, std::index_sequence<Indices...>)
+  {
+    for (std::size_t row = 0; row < _end; ++row)
+    {
+      const auto &pointers = this->rows[row];
+      auto &copies = this->packedRows[row];
+      if (_pack)
+      {
+        ((std::get<Indices>(copies) = *OffsetPointer(
+            std::get<Indices + 1>(pointers), _offsets[Indices])), ...);
+      }
+      else
+      {
+        ((*OffsetPointer(std::get<Indices + 1>(pointers), _offsets[Indices]) =
+            std::get<Indices>(copies)), ...);
+      }
+    }
   }
 
-  /// \brief A map of entities to their component data
-  private: std::unordered_map<Entity, ComponentData> data;
+  /// \brief The entities and their component data. Rows are kept packed, so
+  /// the order of the rows changes when entities are removed
+  private: RowVector rows;
+
+  /// \brief Copies of the components of every row, if the view is packed.
+  /// They're only up to date while a packed Each call is running
+  private: PackedVector packedRows;
+
+  /// \brief Whether the view is packed
+  private: bool packed{false};
+
+  /// \brief A map of entities to their row
+  private: std::unordered_map<Entity, std::size_t> rowIndices;
+};
+
+/// \brief A range over the rows of a view, which can be used in a range-based
+/// for loop. Each row is a std::tuple of an entity and pointers to its
+/// components, so it can be unpacked with a structured binding:
+///   for (const auto &[entity, pose, vel] : ecm.Query<Pose, Velocity>())
+/// The view is pinned while the range exists. Adding or removing components
+/// of the view's types while iterating invalidates the range's iterators
+template<typename ...ComponentTypeTs>
+class ViewRange
+{
+  /// \brief A row of the view
+  public: using ComponentData =
+            typename View<ComponentTypeTs...>::ComponentData;
+
+  /// \brief The offset from the component pointers stored in the view to the
+  /// components that are handed out, per component type (see
+  /// ComponentPool::CurrentOffset)
+  public: using Offsets =
+            std::array<std::ptrdiff_t, sizeof...(ComponentTypeTs)>;
+
+  /// \brief An iterator over the rows of the view. If any of the component
+  /// offsets isn't 0, dereferencing it gives a copy of the row with the
+  /// offsets applied, which stays valid until the iterator is moved
+  public: class const_iterator
+  {
+    /// \brief Iterator traits
+    public: using iterator_category = std::forward_iterator_tag;
+    public: using value_type = ComponentData;
+    public: using difference_type = std::ptrdiff_t;
+    public: using pointer = const ComponentData *;
+    public: using reference = const ComponentData &;
+
+    /// \brief Constructor
+    /// \param[in] _row The row
+    /// \param[in] _offsets The component offsets
+    public: const_iterator(const ComponentData *_row, const Offsets *_offsets)
+      : row(_row), offsets(_offsets),
+        offset(std::any_of(_offsets->begin(), _offsets->end(),
+              [](const std::ptrdiff_t _offset)
+              {
+                return _offset != 0;
+              }))
+    {
+    }
+
+    /// \brief Get the row
+    /// \return The row
+    public: const ComponentData &operator*() const
+    {
+      if (!this->offset)
+        return *this->row;
+      this->offsetRow =
+        this->Apply(std::index_sequence_for<ComponentTypeTs...>());
+      return this->offsetRow;
+    }
+
+    /// \brief Go to the next row
+    /// \return The iterator
+    public: const_iterator &operator++()
+    {
+      ++this->row;
+      return *this;
+    }
+
+    /// \brief Check if two iterators point at the same row
+    /// \param[in] _other The other iterator
+    /// \return true if the iterators are equal
+    public: bool operator==(const const_iterator &_other) const
+    {
+      return this->row == _other.row;
+    }
+
+    /// \brief Check if two iterators point at different rows
+    /// \param[in] _other The other iterator
+    /// \return true if the iterators aren't equal
+    public: bool operator!=(const const_iterator &_other) const
+    {
+      return this->row != _other.row;
+    }
+
+    /// \brief Apply the component offsets to the row
+    /// \return The row with the offsets applied
+    private: template<std::size_t ...Indices>
+             ComponentData Apply(std::index_sequence<Indices...>) const
+    {
+      return ComponentData(std::get<0>(*this->row), OffsetPointer(
+            std::get<Indices + 1>(*this->row), (*this->offsets)[Indices])...);
+    }
+
+    /// \brief The row
+    private: const ComponentData *row;
+
+    /// \brief The component offsets
+    private: const Offsets *offsets;
+
+    /// \brief Whether any of the component offsets isn't 0
+    private: bool offset;
+
+    /// \brief The current row with the offsets applied
+    private: mutable ComponentData offsetRow;
+  };
+
+  /// \brief Constructor
+  /// \param[in] _view The view
+  /// \param[in] _offsets The component offsets
+  public: ViewRange(View<ComponentTypeTs...> *_view, const Offsets &_offsets)
+    : view(_view), offsets(_offsets), pin(_view)
+  {
+  }
+
+  /// \brief Get an iterator to the first row
+  /// \return The iterator
+  public: const_iterator begin() const
+  {
+    return const_iterator(this->view->Rows().data(), &this->offsets);
+  }
+
+  /// \brief Get an iterator past the last row
+  /// \return The iterator
+  public: const_iterator end() const
+  {
+    return const_iterator(this->view->Rows().data() + this->view->EntityCount(),
+        &this->offsets);
+  }
+
+  /// \brief Get the number of rows
+  /// \return The number of rows
+  public: std::size_t size() const
+  {
+    return this->view->EntityCount();
+  }
+
+  /// \brief Check if there are no rows
+  /// \return true if there are no rows, false otherwise
+  public: bool empty() const
+  {
+    return this->view->EntityCount() == 0;
+  }
+
+  /// \brief The view
+  private: View<ComponentTypeTs...> *view;
+
+  /// \brief The component offsets
+  private: Offsets offsets;
+
+  /// \brief Keeps the view from being destroyed while the range exists
+  private: ViewPin pin;
 };
 
 #endif
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Pose and a LinearVelocity, and every pass moves "
+    << "each pose by its" << std::endl << "velocity. A pass is done with one "
+    << "Each(...) call, and spread over EachBudgeted(...)" << std::endl
+    << "calls with a time budget per call." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --budget-us <n>        the time budget per call, in microseconds "
+    << "(default 500)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM has budgeted
+  //    iteration
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--budget-us"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto budgetUs = std::stoi(options.Extra("--budget-us", "500"));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("budgetUs", std::to_string(budgetUs));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities, a "
+    << budgetUs << " us budget per call" << std::endl << options.warmup
+    << " warmup pass(es), " << options.reps << " repetition(s)" << std::endl
+    << std::endl;
+
+  ECM ecm;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    const auto entity = ecm.CreateEntity();
+    ecm.AddComponent(entity, Pose());
+    LinearVelocity linVel;
+    linVel.data = {1, 2, 3};
+    ecm.AddComponent(entity, linVel);
+  }
+
+  int count = 0;
+  const std::function<bool(const Entity &, Pose *, LinearVelocity *)> move =
+    [&count](const Entity &, Pose *_pose, LinearVelocity *_linVel)
+    {
+      _pose->position.x += _linVel->data.x;
+      _pose->position.y += _linVel->data.y;
+      _pose->position.z += _linVel->data.z;
+      count++;
+      return true;
+    };
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+  std::vector<double> eachSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    count = 0;
+    const auto ms = TimeMs([&ecm, &move]()
+        {
+          ecm.Each<Pose, LinearVelocity>(move);
+        });
+    valid = valid && count == numEntities;
+    if (i >= 0)
+      eachSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each(...), one pass", eachSamples));
+
+  EachCursor cursor;
+  EachBudget budget;
+  budget.maxTime = std::chrono::microseconds(budgetUs);
+  std::vector<double> callSamples;
+  std::vector<double> passSamples;
+  std::vector<double> callsPerPass;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    count = 0;
+    double passMs = 0;
+    int calls = 0;
+    bool done = false;
+    while (!done)
+    {
+      const auto ms = TimeMs([&ecm, &cursor, &budget, &move, &done]()
+          {
+            done = ecm.EachBudgeted<Pose, LinearVelocity>(cursor, budget,
+                move);
+          });
+      passMs += ms;
+      calls++;
+      if (i >= 0)
+        callSamples.push_back(ms);
+    }
+    valid = valid && count == numEntities;
+    if (i >= 0)
+    {
+      passSamples.push_back(passMs);
+      callsPerPass.push_back(calls);
+    }
+  }
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "EachBudgeted(...), one call", callSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "EachBudgeted(...), one pass", passSamples));
+
+  double totalCalls = 0;
+  for (const auto calls : callsPerPass)
+    totalCalls += calls;
+  if (!callsPerPass.empty())
+  {
+    std::cout << std::endl << "Calls per pass: "
+      << totalCalls / callsPerPass.size() << std::endl;
+  }
+
+  options.WriteResults(report);
+
+  if (!valid)
+  {
+    std::cerr << std::endl << "A pass visited the wrong number of entities"
+      << std::endl;
+  }
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/BenchmarkRunnerFactory.hh"
+#include "benchmark/BenchmarkStats.hh"
+#include "benchmark/EachComponents.hh"
+#include "memory/ProcessMemory.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> "
+    << "[# of entities to modify per tick] [options]" << std::endl
+    << std::endl
+    << "Every tick, a component is removed from some entities and added back "
+    << "in, and then" << std::endl << "Each(...) is called. The number of "
+    << "entities that are modified per tick defaults" << std::endl
+    << "to 1% of the entities. Scenarios:" << std::endl
+    << "  first          every entity has all of the components, and the "
+    << "first entities" << std::endl
+    << "                 have their LinearVelocity removed and added back"
+    << std::endl
+    << "  random         every entity has all of the components, and random "
+    << "entities have" << std::endl
+    << "                 a random component removed and added back"
+    << std::endl
+    << "  heterogeneous  every entity has a random subset of the components, "
+    << "and random" << std::endl
+    << "                 entities have one of their components removed and "
+    << "added back" << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --scenarios <s,...>  the scenarios to run (default\n"
+    << "                       first,random,heterogeneous)\n"
+    << "  --ticks <n>          the number of ticks (default 2000)\n"
+    << "  --windows <n>        the number of windows the ticks are reported\n"
+    << "                       in (default 10)\n"
+    << "  --seed <n>           the random seed (default 1)\n";
+}
+
+/// \brief Split a comma separated list
+/// \param[in] _list The list
+/// \return The list's items
+std::vector<std::string> SplitList(const std::string &_list)
+{
+  std::vector<std::string> items;
+  std::stringstream stream(_list);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+/// \brief Time a single EachImplementation call and make sure that the right
+/// number of entities were iterated over
+/// \param[in] _runner The runner
+/// \param[in] _targetEntityCount The number of entities that should be
+/// iterated over
+/// \param[out] _valid Set to false if the wrong number of entities were
+/// iterated over
+/// \return The elapsed time, in milliseconds
+double TimeEach(BenchmarkRunner &_runner, const int _targetEntityCount,
+    bool &_valid)
+{
+  _runner.StartTimer();
+  _runner.EachImplementation();
+  _runner.StopTimer();
+  if (!_runner.Valid(_targetEntityCount))
+    _valid = false;
+  return _runner.ElapsedMs();
+}
+
+/// \brief Get the difference between two RSS readings, in MiB
+/// \param[in] _rss The later reading, in bytes
+/// \param[in] _baseRss The earlier reading, in bytes
+/// \return _rss - _baseRss, in MiB
+double RssDeltaMiB(const std::size_t _rss, const std::size_t _baseRss)
+{
+  return (static_cast<double>(_rss) - static_cast<double>(_baseRss)) /
+    (1024.0 * 1024.0);
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * the number of entities to modify per tick (optional)
+  //  * options (see PrintUsage), which may appear anywhere. --reps and
+  //    --instances are ignored, since every tick is a sample
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--scenarios", "--ticks", "--windows",
+        "--seed"}) || options.positional.empty() ||
+      options.positional.size() > 2)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto numModify = options.positional.size() == 2 ?
+    std::stoi(options.positional[1]) : std::max(numEntities / 100, 1);
+  const auto numTicks = std::stoi(options.Extra("--ticks", "2000"));
+  const auto numWindows = std::stoi(options.Extra("--windows", "10"));
+  const auto seed = std::stoul(options.Extra("--seed", "1"));
+  const auto scenarios = SplitList(
+      options.Extra("--scenarios", "first,random,heterogeneous"));
+  if (numModify > numEntities || numTicks < 1 || numWindows < 1 ||
+      numWindows > numTicks)
+  {
+    std::cerr << "The number of entities to modify can't be more than the "
+      << "number of entities, and" << std::endl << "--windows must be "
+      << "between 1 and --ticks" << std::endl;
+    return -1;
+  }
+  for (const auto &scenario : scenarios)
+  {
+    if (scenario != "first" && scenario != "random" &&
+        scenario != "heterogeneous")
+    {
+      std::cerr << "Unknown scenario " << scenario << std::endl;
+      return -1;
+    }
+  }
+  options.Apply();
+
+  auto implementationTypes = BenchmarkRunnerFactory::Types();
+  if (!options.runners.empty())
+    implementationTypes = options.runners;
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("entitiesModifiedPerTick", std::to_string(numModify));
+  options.AddParameters(report);
+
+  std::cout << "Creating ECMs with " << numEntities << " entities, and "
+    << "modifying " << numModify << " entities per tick for " << numTicks
+    << " ticks" << std::endl << options.warmup << " warmup call(s), "
+    << numWindows << " window(s), seed " << seed << std::endl;
+
+  const std::uint16_t allComponents = (1u << kNumEachComponents) - 1;
+  const auto ticksPerWindow = numTicks / numWindows;
+  bool valid = true;
+  for (const auto &scenario : scenarios)
+  {
+    for (const auto &ecmType : implementationTypes)
+    {
+      std::cout << std::endl << "-----" << std::endl << std::endl << ecmType
+        << " implementation, " << scenario << " scenario" << std::endl
+        << std::endl;
+
+      ReleaseFreedMemory();
+      const auto baseRss = CurrentRssBytes();
+      BenchmarkRunner *benchmarkRunner =
+        BenchmarkRunnerFactory::Create(ecmType);
+      if (!benchmarkRunner)
+        continue;
+      benchmarkRunner->Init(0);
+
+      // every runner gets the same entities and modifications
+      std::mt19937 rng(seed);
+      std::vector<std::uint16_t> entityComponents(numEntities, allComponents);
+      if (scenario == "heterogeneous")
+      {
+        std::bernoulli_distribution hasComponent(0.8);
+        for (auto &components : entityComponents)
+        {
+          components = 0;
+          for (std::size_t i = 0; i < kNumEachComponents; ++i)
+            components |= hasComponent(rng) ? (1u << i) : 0u;
+        }
+      }
+      const auto numFull = static_cast<int>(std::count(
+            entityComponents.begin(), entityComponents.end(), allComponents));
+      const auto numModifiable = numEntities - static_cast<int>(std::count(
+            entityComponents.begin(), entityComponents.end(), 0));
+      const auto numToModify = std::min(numModify, numModifiable);
+
+      benchmarkRunner->StartTimer();
+      for (const auto components : entityComponents)
+        benchmarkRunner->MakeEntityWithComponentSubset(components);
+      benchmarkRunner->StopTimer();
+      const auto runner = ecmType + " (" + scenario + ")";
+      BenchmarkReport::Print(std::cout, report.Add(runner, "Create entities",
+            {benchmarkRunner->ElapsedMs()}));
+
+      for (auto i = 0; i <= options.warmup; ++i)
+        TimeEach(*benchmarkRunner, numFull, valid);
+      const auto createdRss = CurrentRssBytes();
+
+      std::uniform_int_distribution<int> pickEntity(0, numEntities - 1);
+      std::vector<bool> touched(numEntities, false);
+      std::vector<std::pair<std::size_t, std::size_t>> modifications;
+      std::vector<double> churnSamples;
+      std::vector<double> eachSamples;
+      std::vector<double> windowMedians;
+      std::vector<double> windowRss;
+      for (auto tick = 0; tick < numTicks; ++tick)
+      {
+        // choose which component to remove from which entities. An entity
+        // is modified at most once per tick
+        modifications.clear();
+        if (scenario == "first")
+        {
+          for (auto i = 0; i < numModify; ++i)
+            modifications.emplace_back(i, 2);
+        }
+        else
+        {
+          while (static_cast<int>(modifications.size()) < numToModify)
+          {
+            const auto entity = pickEntity(rng);
+            const auto components = entityComponents[entity];
+            if (touched[entity] || components == 0)
+              continue;
+
+            std::vector<std::size_t> present;
+            for (std::size_t i = 0; i < kNumEachComponents; ++i)
+            {
+              if (components & (1u << i))
+                present.push_back(i);
+            }
+            std::uniform_int_distribution<std::size_t> pickComponent(0,
+                present.size() - 1);
+            modifications.emplace_back(entity, present[pickComponent(rng)]);
+            touched[entity] = true;
+          }
+          for (const auto &[entity, component] : modifications)
+            touched[entity] = false;
+        }
+
+        benchmarkRunner->StartTimer();
+        for (const auto &[entity, component] : modifications)
+          benchmarkRunner->RemoveComponentFrom(entity, component);
+        for (const auto &[entity, component] : modifications)
+          benchmarkRunner->AddComponentTo(entity, component);
+        benchmarkRunner->StopTimer();
+        churnSamples.push_back(benchmarkRunner->ElapsedMs());
+        eachSamples.push_back(TimeEach(*benchmarkRunner, numFull, valid));
+
+        // the last window also gets the ticks that are left over
+        const auto window = std::min(tick / ticksPerWindow, numWindows - 1);
+        if (tick + 1 < numTicks &&
+            std::min((tick + 1) / ticksPerWindow, numWindows - 1) == window)
+        {
+          continue;
+        }
+
+        // a window is done
+        const auto firstTick = tick + 1 - static_cast<int>(eachSamples.size());
+        const auto ticks = ", ticks " + std::to_string(firstTick) + "-" +
+          std::to_string(tick);
+        BenchmarkReport::Print(std::cout,
+            report.Add(runner, "Each(...)" + ticks, eachSamples));
+        BenchmarkReport::Print(std::cout,
+            report.Add(runner, "Remove and add" + ticks, churnSamples));
+        windowMedians.push_back(ComputeStats(eachSamples).median);
+        windowRss.push_back(RssDeltaMiB(CurrentRssBytes(), baseRss));
+        eachSamples.clear();
+        churnSamples.clear();
+      }
+
+      std::cout << std::endl << "Each(...) median, last window / first "
+        << "window: " << windowMedians.back() / windowMedians.front()
+        << std::endl << "RSS growth (MiB) after creation: "
+        << RssDeltaMiB(createdRss, baseRss) << ", per window:";
+      for (const auto rss : windowRss)
+        std::cout << " " << rss;
+      std::cout << std::endl;
+
+      delete benchmarkRunner;
+    }
+  }
+
+  options.WriteResults(report);
+
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Pose, LinearVelocity and LinearAcceleration. An "
+    << "integrator updates" << std::endl << "the poses and velocities in "
+    << "place with Each(...), and with EachBuffered(...) on" << std::endl
+    << "1, 2, 4, ... threads, with Pose and LinearVelocity double buffered."
+    << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --max-threads <n>      the most integrator threads to run (default: "
+    << "the number of" << std::endl
+    << "                         hardware threads)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief Create the entities of the benchmark. Entity i starts at x = i % 100
+/// with a velocity of i % 7 and an acceleration of 1
+/// \param[in] _ecm The ECM
+/// \param[in] _numEntities The number of entities to create
+void CreateEntities(ECM &_ecm, const int _numEntities)
+{
+  for (auto i = 0; i < _numEntities; ++i)
+  {
+    const auto entity = _ecm.CreateEntity();
+    Pose pose;
+    pose.position.x = i % 100;
+    _ecm.AddComponent(entity, pose);
+    LinearVelocity linVel;
+    linVel.data.x = i % 7;
+    _ecm.AddComponent(entity, linVel);
+    LinearAcceleration linAccel;
+    linAccel.data.x = 1;
+    _ecm.AddComponent(entity, linAccel);
+  }
+}
+
+/// \brief Check that the integrator ran the expected number of steps on every
+/// entity
+/// \param[in] _ecm The ECM
+/// \param[in] _steps The number of steps
+/// \return true if every entity is where it should be, false otherwise
+bool CheckSteps(ECM &_ecm, const int _steps)
+{
+  bool valid = true;
+  _ecm.Each<Pose, LinearVelocity>(
+      std::function<bool(const Entity &, Pose *, LinearVelocity *)>(
+        [&valid, _steps](const Entity &_entity, Pose *_pose,
+            LinearVelocity *_linVel)
+        {
+          // entities are numbered from 0 in creation order
+          const auto x0 = static_cast<int>(_entity % 100);
+          const auto v0 = static_cast<int>(_entity % 7);
+          valid = valid && _linVel->data.x == v0 + _steps &&
+            _pose->position.x == x0 + v0 * _steps + _steps * (_steps - 1) / 2;
+          return valid;
+        }));
+  return valid;
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM supports double
+  //    buffering
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--max-threads"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto hardwareThreads =
+    std::max(1u, std::thread::hardware_concurrency());
+  const auto maxThreads = std::stoi(
+      options.Extra("--max-threads", std::to_string(hardwareThreads)));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("hardwareThreads", std::to_string(hardwareThreads));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities, "
+    << "up to " << maxThreads << " integrator thread(s)" << std::endl
+    << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+
+  // single buffered baseline: every component is updated in place, which is
+  // only safe on one thread
+  {
+    ECM ecm;
+    CreateEntities(ecm, numEntities);
+    const std::function<bool(const Entity &, Pose *, LinearVelocity *,
+        LinearAcceleration *)> integrate =
+      [](const Entity &, Pose *_pose, LinearVelocity *_linVel,
+          LinearAcceleration *_linAccel)
+      {
+        _pose->position.x += _linVel->data.x;
+        _linVel->data.x += _linAccel->data.x;
+        return true;
+      };
+
+    std::vector<double> samples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      const auto ms = TimeMs([&ecm, &integrate]()
+          {
+            ecm.Each<Pose, LinearVelocity, LinearAcceleration>(integrate);
+          });
+      if (i >= 0)
+        samples.push_back(ms);
+    }
+    valid = CheckSteps(ecm, options.warmup + options.reps) && valid;
+    BenchmarkReport::Print(std::cout,
+        report.Add(runner, "Each(...) in place, 1 thread", samples));
+  }
+
+  // double buffered: the integrator reads the current poses and velocities
+  // and writes the next ones, so the entities can be split up between threads
+  ECM ecm;
+  CreateEntities(ecm, numEntities);
+  ecm.SetDoubleBuffered<Pose>();
+  ecm.SetDoubleBuffered<LinearVelocity>();
+  const ECM::BufferedCallback<Pose, LinearVelocity, LinearAcceleration>::Type
+    integrate = [](const Entity &, const Pose *_pose,
+        const LinearVelocity *_linVel, const LinearAcceleration *_linAccel,
+        Pose *_nextPose, LinearVelocity *_nextLinVel, LinearAcceleration *)
+    {
+      *_nextPose = *_pose;
+      _nextPose->position.x += _linVel->data.x;
+      *_nextLinVel = *_linVel;
+      _nextLinVel->data.x += _linAccel->data.x;
+      return true;
+    };
+
+  std::vector<int> threadCounts;
+  for (auto numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+    threadCounts.push_back(numThreads);
+  threadCounts.push_back(maxThreads);
+
+  auto steps = 0;
+  std::vector<double> swapSamples;
+  for (const auto numThreads : threadCounts)
+  {
+    std::vector<double> samples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      const auto ms = TimeMs([&ecm, &integrate, numThreads]()
+          {
+            ecm.EachBuffered<Pose, LinearVelocity, LinearAcceleration>(
+                integrate, numThreads);
+          });
+      const auto swapMs = TimeMs([&ecm]()
+          {
+            ecm.SwapBuffers();
+          });
+      steps++;
+      if (i >= 0)
+      {
+        samples.push_back(ms);
+        swapSamples.push_back(swapMs);
+      }
+    }
+
+    // the results must not depend on the number of threads
+    valid = CheckSteps(ecm, steps) && valid;
+    BenchmarkReport::Print(std::cout, report.Add(runner,
+          "EachBuffered(...), " + std::to_string(numThreads) + " thread(s)",
+          samples));
+  }
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "SwapBuffers()", swapSamples));
+
+  options.WriteResults(report);
+
+  if (!valid)
+  {
+    std::cerr << std::endl << "The integrator produced the wrong results"
+      << std::endl;
+  }
+  return valid ? 0 : 1;
+}
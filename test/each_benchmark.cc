@@ -1,60 +1,397 @@
 #include <cstddef>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
 #include "benchmark/BenchmarkRunner.hh"
 #include "benchmark/BenchmarkRunnerFactory.hh"
+#include "benchmark/BenchmarkStats.hh"
+#include "benchmark/EachComponents.hh"
+#include "benchmark/ExtraComponents.hh"
+#include "memory/ProcessMemory.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  const std::string entityCreationStr = "<# of entities to create>";
+  const std::string entityAddRemoveCompStr =
+    "[# of entities to add/remove components]";
+  std::cerr << "Usage: " << _program << " " << entityCreationStr << " "
+    << entityAddRemoveCompStr << " [options]" << std::endl
+    << "       " << _program << " --sweep <csv file> [options]" << std::endl
+    << std::endl
+    << entityAddRemoveCompStr << " should be <= than " << entityCreationStr
+    << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --sweep <file>   benchmark every combination of the values below,\n"
+    << "                   and write the median times to a CSV file\n"
+    << "  --sweep-entities <n,...>\n"
+    << "                   entity counts to sweep (default\n"
+    << "                   1000,10000,100000,1000000,10000000)\n"
+    << "  --sweep-components <n,...>\n"
+    << "                   components per entity to sweep, between "
+    << kNumEachComponents << " and "
+    << kNumEachComponents + kMaxExtraComponents << "\n"
+    << "                   (default 10,14,18)\n"
+    << "  --sweep-fractions <f,...>\n"
+    << "                   fractions of the entities that have a component\n"
+    << "                   removed and added back in (default 0,0.01,0.1)\n"
+    << "  --huge-pages <0|1>\n"
+    << "                   allocate ECM storage from memory that is backed by\n"
+    << "                   huge pages (default 0). Runners that can't are\n"
+    << "                   skipped\n";
+}
+
+/// \brief Split a comma separated list
+/// \param[in] _list The list
+/// \return The list's items
+std::vector<std::string> SplitList(const std::string &_list)
+{
+  std::vector<std::string> items;
+  std::stringstream stream(_list);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+/// \brief Time a single EachImplementation call and make sure that the right
+/// number of entities were iterated over
+/// \param[in] _runner The runner
+/// \param[in] _targetEntityCount The number of entities that should be
+/// iterated over
+/// \param[out] _valid Set to false if the wrong number of entities were
+/// iterated over
+/// \return The elapsed time, in milliseconds
+double TimeEach(BenchmarkRunner &_runner, const int _targetEntityCount,
+    bool &_valid)
+{
+  _runner.StartTimer();
+  _runner.EachImplementation();
+  _runner.StopTimer();
+  if (!_runner.Valid(_targetEntityCount))
+    _valid = false;
+  return _runner.ElapsedMs();
+}
+
+/// \brief The samples that are measured for a runner, in milliseconds
+struct RunnerSamples
+{
+  /// \brief Creating all of the entities, once per instance
+  std::vector<double> create;
+
+  /// \brief The first Each(...) call, once per instance
+  std::vector<double> firstEach;
+
+  /// \brief Each(...) calls once the view exists
+  std::vector<double> each;
+
+  /// \brief Removing a component from some of the entities
+  std::vector<double> remove;
+
+  /// \brief Each(...) calls right after removing components
+  std::vector<double> eachAfterRemove;
+
+  /// \brief Adding the removed components back in
+  std::vector<double> add;
+
+  /// \brief Each(...) calls right after adding components
+  std::vector<double> eachAfterAdd;
+
+  /// \brief The bytes that the last instance mapped for huge pages
+  std::size_t hugePageBytes{0};
+
+  /// \brief The bytes of the process that were backed by huge pages while
+  /// the last instance existed
+  std::size_t anonHugePageBytes{0};
+};
+
+/// \brief Measure entity creation, Each(...) calls and (optionally) adding
+/// and removing a component for a runner
+/// \param[in] _type The runner type (see BenchmarkRunnerFactory)
+/// \param[in] _options The benchmark options
+/// \param[in] _numEntities The number of entities to create
+/// \param[in] _numExtraComponents The number of extra components per entity
+/// \param[in] _addAndRemoveComps Whether components should be removed and
+/// added back in between Each(...) calls
+/// \param[in] _numEntitiesAddRemoveComp The number of entities that should
+/// have a component removed and added back in
+/// \param[out] _samples The samples that were measured
+/// \param[in,out] _valid Set to false if an Each(...) call iterated over the
+/// wrong number of entities
+/// \return false if the runner couldn't be created, or doesn't support
+/// _numExtraComponents or the --huge-pages option
+bool MeasureRunner(const std::string &_type, const BenchmarkOptions &_options,
+    const int _numEntities, const int _numExtraComponents,
+    const bool _addAndRemoveComps, const int _numEntitiesAddRemoveComp,
+    RunnerSamples &_samples, bool &_valid)
+{
+  // entity creation and the first Each(...) call (which has to create the
+  // view) can only be measured once per ECM, so a few ECMs are created
+  BenchmarkRunner *benchmarkRunner = nullptr;
+  for (auto instance = 0; instance < _options.instances; ++instance)
+  {
+    delete benchmarkRunner;
+    benchmarkRunner = BenchmarkRunnerFactory::Create(_type);
+    if (!benchmarkRunner)
+      return false;
+    if (!benchmarkRunner->SetExtraComponents(_numExtraComponents) ||
+        !benchmarkRunner->SetHugePages(
+          _options.Extra("--huge-pages", "0") == "1"))
+    {
+      delete benchmarkRunner;
+      return false;
+    }
+
+    // instantiate the ecm and populate it with entities/components
+    benchmarkRunner->Init(_numEntitiesAddRemoveComp);
+    benchmarkRunner->StartTimer();
+    for (auto i = 0; i < _numEntities; ++i)
+      benchmarkRunner->MakeEntityWithComponents();
+    benchmarkRunner->StopTimer();
+    _samples.create.push_back(benchmarkRunner->ElapsedMs());
+
+    _samples.firstEach.push_back(
+        TimeEach(*benchmarkRunner, _numEntities, _valid));
+  }
+
+  // once the view is created, subsequent Each(...) calls should be
+  // noticeably faster
+  for (auto i = 0; i < _options.warmup; ++i)
+    TimeEach(*benchmarkRunner, _numEntities, _valid);
+  for (auto i = 0; i < _options.reps; ++i)
+    _samples.each.push_back(TimeEach(*benchmarkRunner, _numEntities, _valid));
+
+  if (_addAndRemoveComps)
+  {
+    const auto numRemaining = _numEntities - _numEntitiesAddRemoveComp;
+    for (auto i = -_options.warmup; i < _options.reps; ++i)
+    {
+      // remove components from entities, and then call Each(...)
+      benchmarkRunner->StartTimer();
+      benchmarkRunner->RemoveAComponent();
+      benchmarkRunner->StopTimer();
+      const auto removeMs = benchmarkRunner->ElapsedMs();
+      const auto eachAfterRemoveMs =
+        TimeEach(*benchmarkRunner, numRemaining, _valid);
+
+      // add components to entities, and then call Each(...)
+      benchmarkRunner->StartTimer();
+      benchmarkRunner->AddAComponent();
+      benchmarkRunner->StopTimer();
+      const auto addMs = benchmarkRunner->ElapsedMs();
+      const auto eachAfterAddMs =
+        TimeEach(*benchmarkRunner, _numEntities, _valid);
+
+      // negative iterations are warmup iterations
+      if (i < 0)
+        continue;
+      _samples.remove.push_back(removeMs);
+      _samples.eachAfterRemove.push_back(eachAfterRemoveMs);
+      _samples.add.push_back(addMs);
+      _samples.eachAfterAdd.push_back(eachAfterAddMs);
+    }
+  }
+
+  _samples.hugePageBytes = benchmarkRunner->HugePageBytes();
+  _samples.anonHugePageBytes = AnonHugePageBytes();
+  delete benchmarkRunner;
+  return true;
+}
+
+/// \brief Benchmark every runner over every combination of entity count,
+/// components per entity and add/remove fraction, and write the median times
+/// to a CSV file (one row per runner and combination)
+/// \param[in] _options The benchmark options
+/// \param[in] _runners The runners to benchmark
+/// \param[in,out] _report The report, which gets a result per runner, metric
+/// and combination
+/// \return 0 if the sweep succeeded, nonzero otherwise
+int Sweep(const BenchmarkOptions &_options,
+    const std::vector<std::string> &_runners, BenchmarkReport &_report)
+{
+  std::vector<int> entityCounts;
+  for (const auto &item : SplitList(_options.Extra("--sweep-entities",
+          "1000,10000,100000,1000000,10000000")))
+  {
+    entityCounts.push_back(std::stoi(item));
+  }
+  std::vector<int> componentCounts;
+  for (const auto &item :
+       SplitList(_options.Extra("--sweep-components", "10,14,18")))
+  {
+    componentCounts.push_back(std::stoi(item));
+    if (componentCounts.back() < static_cast<int>(kNumEachComponents) ||
+        componentCounts.back() > static_cast<int>(kNumEachComponents +
+          kMaxExtraComponents))
+    {
+      std::cerr << "Components per entity must be between "
+        << kNumEachComponents << " and "
+        << kNumEachComponents + kMaxExtraComponents << std::endl;
+      return -1;
+    }
+  }
+  std::vector<double> fractions;
+  for (const auto &item :
+       SplitList(_options.Extra("--sweep-fractions", "0,0.01,0.1")))
+  {
+    fractions.push_back(std::stod(item));
+    if (fractions.back() < 0.0 || fractions.back() > 1.0)
+    {
+      std::cerr << "Add/remove fractions must be between 0 and 1"
+        << std::endl;
+      return -1;
+    }
+  }
+
+  const auto sweepFile = _options.Extra("--sweep");
+  std::ofstream csv(sweepFile);
+  if (!csv)
+  {
+    std::cerr << "Unable to open " << sweepFile << std::endl;
+    return -1;
+  }
+  csv << std::setprecision(9) << "runner,entities,components_per_entity,"
+    << "add_remove_fraction,entities_add_remove,create_ms,first_each_ms,"
+    << "each_ms,remove_ms,each_after_remove_ms,add_ms,each_after_add_ms"
+    << std::endl;
+
+  std::cout << "Sweeping " << _runners.size() << " runner(s) over "
+    << entityCounts.size() << " entity count(s), " << componentCounts.size()
+    << " component count(s) and " << fractions.size()
+    << " add/remove fraction(s)" << std::endl << _options.instances
+    << " instance(s) per runner, " << _options.warmup << " warmup call(s), "
+    << _options.reps << " repetition(s)" << std::endl << std::endl;
+
+  // the median of the samples, or an empty CSV field if there are none
+  const auto median = [](const std::vector<double> &_samples)
+  {
+    std::stringstream field;
+    if (!_samples.empty())
+      field << std::setprecision(9) << ComputeStats(_samples).median;
+    return field.str();
+  };
+
+  bool valid = true;
+  for (const auto numEntities : entityCounts)
+  {
+    for (const auto numComponents : componentCounts)
+    {
+      for (const auto fraction : fractions)
+      {
+        const auto numModify = static_cast<int>(numEntities * fraction);
+        for (const auto &ecmType : _runners)
+        {
+          std::cout << ecmType << ": " << numEntities << " entities, "
+            << numComponents << " components per entity, " << numModify
+            << " entities adding/removing a component" << std::endl;
+
+          RunnerSamples samples;
+          if (!MeasureRunner(ecmType, _options, numEntities,
+                numComponents - static_cast<int>(kNumEachComponents),
+                fraction > 0.0, numModify, samples, valid))
+          {
+            std::cout << "  not supported, skipping" << std::endl;
+            continue;
+          }
+
+          csv << ecmType << "," << numEntities << "," << numComponents << ","
+            << fraction << "," << numModify << "," << median(samples.create)
+            << "," << median(samples.firstEach) << "," << median(samples.each)
+            << "," << median(samples.remove) << ","
+            << median(samples.eachAfterRemove) << "," << median(samples.add)
+            << "," << median(samples.eachAfterAdd) << std::endl;
+
+          const auto suffix = " [" + std::to_string(numEntities) +
+            " entities, " + std::to_string(numComponents) +
+            " components, " + std::to_string(numModify) + " modified]";
+          _report.Add(ecmType, "Create entities" + suffix, samples.create);
+          _report.Add(ecmType, "First Each(...)" + suffix, samples.firstEach);
+          _report.Add(ecmType, "Each(...)" + suffix, samples.each);
+          if (fraction > 0.0)
+          {
+            _report.Add(ecmType, "Remove a component" + suffix,
+                samples.remove);
+            _report.Add(ecmType, "Add a component" + suffix, samples.add);
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << std::endl << "Wrote sweep results to " << sweepFile
+    << std::endl;
+  return valid ? 0 : 1;
+}
 
 int main(int argc, char **argv)
 {
   // command line arguments are as follows:
-  //  * the number of entities to create (required)
+  //  * the number of entities to create (required, unless --sweep is given)
   //  * the number of entities that should have a component added/removed
   //    in between Each calls (optional). If this argument is not specified,
   //    no components will be added/removed from entities between Each calls
+  //  * options (see PrintUsage), which may appear anywhere
   int numEntitiesCreated = 0;
   int numEntitiesAddRemoveComp = 0;
   bool addAndRemoveComps = false;
-  if (argc >= 2)
+
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--sweep", "--sweep-entities",
+        "--sweep-components", "--sweep-fractions", "--huge-pages"}))
   {
-    numEntitiesCreated = std::stoi(argv[1]);
-    if (argc == 3)
-    {
-      numEntitiesAddRemoveComp = std::stoi(argv[2]);
-      addAndRemoveComps = true;
-      if (numEntitiesAddRemoveComp > numEntitiesCreated)
-      {
-        std::cerr << numEntitiesCreated
-          << " entities are requested to be created, but "
-          << numEntitiesAddRemoveComp
-          << " entities should have components added/removed."
-          << std::endl << "This isn't possible!" << std::endl;
-        return -1;
-      }
-    }
+    PrintUsage(argv[0]);
+    return -1;
   }
-  else
+  const bool sweep = !options.Extra("--sweep").empty();
+  if ((sweep && !options.positional.empty()) ||
+      (!sweep && (options.positional.empty() ||
+                  options.positional.size() > 2)))
   {
-    const std::string entityCreationStr = "<# of entities to create>";
-    const std::string entityAddRemoveCompStr =
-      "[# of entities to add/remove components]";
-    std::cerr << "Usage: " << argv[0] << entityCreationStr << " "
-      << entityAddRemoveCompStr << std::endl << std::endl
-      << entityAddRemoveCompStr << " should be <= than " << entityCreationStr
-      << std::endl;
+    PrintUsage(argv[0]);
     return -1;
   }
+  options.Apply();
 
   // all of the ECM implementations that will be benchmarked
-  std::vector<std::string> implementationTypes{"simpleECM"};
-#ifdef _ENTT
-  implementationTypes.push_back("entt group");
-  implementationTypes.push_back("entt view");
-#endif // _ENTT
-#ifdef _IGN_GAZEBO
-  implementationTypes.push_back("ignGazebo");
-#endif // _IGN_GAZEBO
+  auto implementationTypes = BenchmarkRunnerFactory::Types();
+  if (!options.runners.empty())
+    implementationTypes = options.runners;
+
+  BenchmarkReport report;
+  if (sweep)
+  {
+    options.AddParameters(report);
+    const auto result = Sweep(options, implementationTypes, report);
+    options.WriteResults(report);
+    return result;
+  }
+
+  const auto &positionalArgs = options.positional;
+  numEntitiesCreated = std::stoi(positionalArgs[0]);
+  if (positionalArgs.size() == 2)
+  {
+    numEntitiesAddRemoveComp = std::stoi(positionalArgs[1]);
+    addAndRemoveComps = true;
+    if (numEntitiesAddRemoveComp > numEntitiesCreated)
+    {
+      std::cerr << numEntitiesCreated
+        << " entities are requested to be created, but "
+        << numEntitiesAddRemoveComp
+        << " entities should have components added/removed."
+        << std::endl << "This isn't possible!" << std::endl;
+      return -1;
+    }
+  }
 
   // creating numEntites entities with the following components (10 total):
   //  name
@@ -67,81 +404,66 @@ int main(int argc, char **argv)
   //  world linear acceleration
   //  pose
   //  world pose
-  const int numComponents = 10;
   std::cout << "Creating an ECM with " << numEntitiesCreated << " entities, with "
-    << numComponents << " components per entity" << std::endl;
+    << kNumEachComponents << " components per entity" << std::endl
+    << options.instances << " instance(s) per runner, " << options.warmup
+    << " warmup call(s), " << options.reps << " repetition(s)" << std::endl;
 
-  // the number of times we will call Each(...) on the ECM
-  const int numEachCalls = 3;
+  report.SetParameter("entities", std::to_string(numEntitiesCreated));
+  report.SetParameter("componentsPerEntity",
+      std::to_string(kNumEachComponents));
+  report.SetParameter("entitiesAddRemoveComponent",
+      std::to_string(numEntitiesAddRemoveComp));
+  options.AddParameters(report);
 
-  for (std::size_t typeIdx = 0; typeIdx < implementationTypes.size(); ++typeIdx)
+  bool valid = true;
+  for (const auto &ecmType : implementationTypes)
   {
-    const auto &ecmType = implementationTypes[typeIdx];
-    auto benchmarkRunner = BenchmarkRunnerFactory::Create(ecmType);
-    if (!benchmarkRunner)
-      continue;
     std::cout << std::endl << "-----" << std::endl << std::endl
       << ecmType << " implementation" << std::endl << std::endl;
 
-    // instantiate the ecm and populate it with entities/components
-    benchmarkRunner->Init(numEntitiesAddRemoveComp);
-    for (auto i = 0; i < numEntitiesCreated; ++i)
-      benchmarkRunner->MakeEntityWithComponents();
-
-    // call Each(...) a few times and see how long it takes to find the entities
-    // with all of the defined components (this first Each(...) call should take
-    // the longest since it has to create the view - once the view is created,
-    // subsequent Each(...) calls should be noticeably faster)
-    std::cout << "Calling Each(...) " << numEachCalls  << " times on "
-      << numEntitiesCreated << " created entities, with " << numComponents
-      << " components per entity" << std::endl;
-    for (auto i = 0; i < numEachCalls; ++i)
+    RunnerSamples samples;
+    if (!MeasureRunner(ecmType, options, numEntitiesCreated, 0,
+          addAndRemoveComps, numEntitiesAddRemoveComp, samples, valid))
     {
-      benchmarkRunner->StartTimer();
-      benchmarkRunner->EachImplementation();
-      benchmarkRunner->StopTimer();
-      if (benchmarkRunner->Valid(numEntitiesCreated))
-        benchmarkRunner->DisplayElapsedTime();
+      std::cout << "Not supported with these options, skipping" << std::endl;
+      continue;
     }
 
+    BenchmarkReport::Print(std::cout,
+        report.Add(ecmType, "Create entities", samples.create));
+    BenchmarkReport::Print(std::cout,
+        report.Add(ecmType, "First Each(...)", samples.firstEach));
+    BenchmarkReport::Print(std::cout,
+        report.Add(ecmType, "Each(...)", samples.each));
+
     if (addAndRemoveComps)
     {
-      std::cout << std::endl;
-
-      for (auto i = 0; i < numEachCalls; ++i)
-      {
-        // remove components from entities, and then call Each(...)
-        benchmarkRunner->StartTimer();
-        benchmarkRunner->RemoveAComponent();
-        benchmarkRunner->StopTimer();
-        benchmarkRunner->DisplayElapsedTime("Removing a component from "
-            + std::to_string(numEntitiesAddRemoveComp) + " entities: ");
-        benchmarkRunner->StartTimer();
-        benchmarkRunner->EachImplementation();
-        benchmarkRunner->StopTimer();
-        if (benchmarkRunner->Valid(
-              numEntitiesCreated - numEntitiesAddRemoveComp))
-          benchmarkRunner->DisplayElapsedTime("Each(...): ");
-
-        // add components to entities, and then call Each(...)
-        benchmarkRunner->StartTimer();
-        benchmarkRunner->AddAComponent();
-        benchmarkRunner->StopTimer();
-        benchmarkRunner->DisplayElapsedTime("Adding a component to "
-            + std::to_string(numEntitiesAddRemoveComp) + " entities: ");
-        benchmarkRunner->StartTimer();
-        benchmarkRunner->EachImplementation();
-        benchmarkRunner->StopTimer();
-        if (benchmarkRunner->Valid(numEntitiesCreated))
-          benchmarkRunner->DisplayElapsedTime("Each(...): ");
-      }
-
-      std::cout << std::endl;
+      const auto numModifiedStr = std::to_string(numEntitiesAddRemoveComp);
+      BenchmarkReport::Print(std::cout, report.Add(ecmType,
+            "Remove a component (" + numModifiedStr + " entities)",
+            samples.remove));
+      BenchmarkReport::Print(std::cout,
+          report.Add(ecmType, "Each(...) after remove",
+            samples.eachAfterRemove));
+      BenchmarkReport::Print(std::cout, report.Add(ecmType,
+            "Add a component (" + numModifiedStr + " entities)",
+            samples.add));
+      BenchmarkReport::Print(std::cout,
+          report.Add(ecmType, "Each(...) after add", samples.eachAfterAdd));
     }
 
-    delete benchmarkRunner;
-    benchmarkRunner = nullptr;
+    // the kernel can back huge page mappings with regular pages, so what it
+    // actually gave out is reported too
+    if (options.Extra("--huge-pages", "0") == "1")
+    {
+      std::cout << "Huge page mappings: " << samples.hugePageBytes
+        << " bytes, backed by huge pages: " << samples.anonHugePageBytes
+        << " bytes" << std::endl;
+    }
   }
 
-  return 0;
+  options.WriteResults(report);
+
+  return valid ? 0 : 1;
 }
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/BenchmarkRunnerFactory.hh"
+#include "benchmark/BenchmarkStats.hh"
+#include "memory/ProcessMemory.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " [# of entities to create] [options]"
+    << std::endl << std::endl
+    << "Compares Each(...) over ECMs whose storage is allocated from regular "
+    << "pages and" << std::endl << "from memory that is backed by huge pages. "
+    << "The number of entities defaults to" << std::endl << "10000000. "
+    << "Runners that can't use huge pages are skipped." << std::endl
+    << std::endl << "Options:" << std::endl << BenchmarkOptions::Usage();
+}
+
+/// \brief Time a single EachImplementation call and make sure that the right
+/// number of entities were iterated over
+/// \param[in] _runner The runner
+/// \param[in] _targetEntityCount The number of entities that should be
+/// iterated over
+/// \param[out] _valid Set to false if the wrong number of entities were
+/// iterated over
+/// \return The elapsed time, in milliseconds
+double TimeEach(BenchmarkRunner &_runner, const int _targetEntityCount,
+    bool &_valid)
+{
+  _runner.StartTimer();
+  _runner.EachImplementation();
+  _runner.StopTimer();
+  if (!_runner.Valid(_targetEntityCount))
+    _valid = false;
+  return _runner.ElapsedMs();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (optional, default 10000000)
+  //  * options (see PrintUsage), which may appear anywhere. --instances is
+  //    ignored, since every runner creates one ECM per page size
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv) || options.positional.size() > 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = options.positional.empty() ? 10000000 :
+    std::stoi(options.positional[0]);
+  options.Apply();
+
+  auto implementationTypes = BenchmarkRunnerFactory::Types();
+  if (!options.runners.empty())
+    implementationTypes = options.runners;
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  std::cout << "Creating ECMs with " << numEntities << " entities, with "
+    << "regular pages and with huge pages" << std::endl << options.warmup
+    << " warmup call(s), " << options.reps << " repetition(s)" << std::endl;
+
+  bool valid = true;
+  for (const auto &ecmType : implementationTypes)
+  {
+    std::cout << std::endl << "-----" << std::endl << std::endl << ecmType
+      << " implementation" << std::endl;
+
+    std::vector<double> eachMedians;
+    for (const auto hugePages : {false, true})
+    {
+      ReleaseFreedMemory();
+      BenchmarkRunner *benchmarkRunner =
+        BenchmarkRunnerFactory::Create(ecmType);
+      if (!benchmarkRunner)
+        break;
+      // runners that can't use huge pages have nothing to compare. The ECM
+      // is still empty, so switching back to regular pages is free
+      if (!benchmarkRunner->SetHugePages(true))
+      {
+        std::cout << std::endl << "This implementation can't use huge pages"
+          << std::endl;
+        delete benchmarkRunner;
+        break;
+      }
+      benchmarkRunner->SetHugePages(hugePages);
+      benchmarkRunner->Init(0);
+
+      const auto runner =
+        ecmType + (hugePages ? " (huge pages)" : " (regular pages)");
+      std::cout << std::endl;
+      benchmarkRunner->StartTimer();
+      for (auto i = 0; i < numEntities; ++i)
+        benchmarkRunner->MakeEntityWithComponents();
+      benchmarkRunner->StopTimer();
+      BenchmarkReport::Print(std::cout, report.Add(runner, "Create entities",
+            {benchmarkRunner->ElapsedMs()}));
+
+      // the first call creates the view, which is allocated like the rest of
+      // the ECM's storage
+      for (auto i = 0; i <= options.warmup; ++i)
+        TimeEach(*benchmarkRunner, numEntities, valid);
+      std::vector<double> eachSamples;
+      for (auto i = 0; i < options.reps; ++i)
+        eachSamples.push_back(TimeEach(*benchmarkRunner, numEntities, valid));
+      const auto &each = report.Add(runner, "Each(...)", eachSamples);
+      BenchmarkReport::Print(std::cout, each);
+      eachMedians.push_back(each.stats.median);
+
+      // the kernel can back huge page mappings with regular pages (if huge
+      // pages are turned off or fragmented), so what it actually gave out is
+      // reported too
+      std::cout << "Huge page mappings: " << benchmarkRunner->HugePageBytes()
+        << " bytes, backed by huge pages: " << AnonHugePageBytes()
+        << " bytes" << std::endl;
+
+      delete benchmarkRunner;
+    }
+
+    if (eachMedians.size() == 2)
+    {
+      std::cout << std::endl << "Each(...) median, huge pages / regular "
+        << "pages: " << eachMedians[1] / eachMedians[0] << std::endl;
+    }
+  }
+
+  options.WriteResults(report);
+
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+#ifndef BENCHMARK_OPTIONS_HH_
+#define BENCHMARK_OPTIONS_HH_
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkReport.hh"
+#include "benchmark/ThreadAffinity.hh"
+#include "simpleECM/Trace.hh"
+
+/// \brief Command line options that are shared by the benchmark executables.
+/// Options have the form "--name value" and may appear anywhere on the
+/// command line. Everything else is a positional argument
+struct BenchmarkOptions
+{
+  /// \brief Parse the command line
+  /// \param[in] _argc The number of command line arguments
+  /// \param[in] _argv The command line arguments
+  /// \param[in] _extraOptions Options (besides the shared ones) that the
+  /// benchmark accepts. Their values are stored in extra
+  /// \return true if the command line was valid, false otherwise (the reason
+  /// is written to std::cerr)
+  bool Parse(int _argc, char **_argv,
+      const std::vector<std::string> &_extraOptions = {});
+
+  /// \brief Get a description of the shared options, for usage messages
+  /// \return The description
+  static std::string Usage();
+
+  /// \brief Get the value of an extra option
+  /// \param[in] _name The option (for example, "--sweep")
+  /// \param[in] _default The value to use if the option wasn't given
+  /// \return The option value
+  std::string Extra(const std::string &_name,
+      const std::string &_default = "") const;
+
+  /// \brief Apply the options that affect the benchmark process (pinning)
+  void Apply() const;
+
+  /// \brief Record the shared options as parameters of a report
+  /// \param[in] _report The report
+  void AddParameters(BenchmarkReport &_report) const;
+
+  /// \brief Write a report to the JSON/CSV files that were requested, and the
+  /// recorded trace to the trace file that was requested
+  /// \param[in] _report The report
+  void WriteResults(const BenchmarkReport &_report) const;
+
+  /// \brief Untimed calls made before measuring
+  int warmup{10};
+
+  /// \brief Timed repetitions of each operation
+  int reps{100};
+
+  /// \brief ECMs created per runner to measure operations that can only
+  /// happen once per ECM (entity creation, building a view, etc.)
+  int instances{3};
+
+  /// \brief The CPU to pin the benchmark thread to (-1 for no pinning)
+  int pinCpu{-1};
+
+  /// \brief File to write JSON results to (empty for none)
+  std::string jsonFile;
+
+  /// \brief File to write CSV results to (empty for none)
+  std::string csvFile;
+
+  /// \brief File to write a Chrome trace to (empty for none)
+  std::string traceFile;
+
+  /// \brief The runners to benchmark (empty for all runners)
+  std::vector<std::string> runners;
+
+  /// \brief The positional arguments
+  std::vector<std::string> positional;
+
+  /// \brief Values of the extra options that were given
+  std::map<std::string, std::string> extra;
+};
+
+bool BenchmarkOptions::Parse(int _argc, char **_argv,
+    const std::vector<std::string> &_extraOptions)
+{
+  for (auto i = 1; i < _argc; ++i)
+  {
+    const std::string arg = _argv[i];
+    if (arg.rfind("--", 0) != 0)
+    {
+      this->positional.push_back(arg);
+      continue;
+    }
+
+    if (i + 1 >= _argc)
+    {
+      std::cerr << "Missing value for option " << arg << std::endl;
+      return false;
+    }
+    const std::string value = _argv[++i];
+
+    if (arg == "--warmup")
+      this->warmup = std::stoi(value);
+    else if (arg == "--reps")
+      this->reps = std::stoi(value);
+    else if (arg == "--instances")
+      this->instances = std::stoi(value);
+    else if (arg == "--pin")
+      this->pinCpu = std::stoi(value);
+    else if (arg == "--runner")
+      this->runners.push_back(value);
+    else if (arg == "--json")
+      this->jsonFile = value;
+    else if (arg == "--csv")
+      this->csvFile = value;
+    else if (arg == "--trace")
+      this->traceFile = value;
+    else
+    {
+      bool known = false;
+      for (const auto &option : _extraOptions)
+        known = known || option == arg;
+      if (!known)
+      {
+        std::cerr << "Unknown option " << arg << std::endl;
+        return false;
+      }
+      this->extra[arg] = value;
+    }
+  }
+
+  if (this->reps < 1 || this->instances < 1 || this->warmup < 0)
+  {
+    std::cerr << "--reps and --instances must be at least 1, and --warmup "
+      << "can't be negative" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::string BenchmarkOptions::Usage()
+{
+  return
+    "  --warmup <n>     untimed calls before measuring (default 10)\n"
+    "  --reps <n>       timed repetitions of each operation (default 100)\n"
+    "  --instances <n>  ECMs created per runner to measure operations that\n"
+    "                   only happen once per ECM (default 3)\n"
+    "  --pin <cpu>      pin the benchmark thread to a CPU\n"
+    "  --runner <name>  only benchmark this runner (can be repeated)\n"
+    "  --json <file>    write the results as JSON\n"
+    "  --csv <file>     write the results as CSV\n"
+    "  --trace <file>   write simple ECM trace points as a Chrome trace\n"
+    "                   (requires building with ENABLE_TRACING)\n";
+}
+
+std::string BenchmarkOptions::Extra(const std::string &_name,
+    const std::string &_default) const
+{
+  auto iter = this->extra.find(_name);
+  if (iter == this->extra.end())
+    return _default;
+  return iter->second;
+}
+
+void BenchmarkOptions::Apply() const
+{
+  if (this->pinCpu >= 0 && PinCurrentThread(this->pinCpu))
+  {
+    std::cout << "Pinned the benchmark thread to CPU " << this->pinCpu
+      << std::endl;
+  }
+}
+
+void BenchmarkOptions::AddParameters(BenchmarkReport &_report) const
+{
+  _report.SetParameter("instances", std::to_string(this->instances));
+  _report.SetParameter("warmup", std::to_string(this->warmup));
+  _report.SetParameter("repetitions", std::to_string(this->reps));
+  _report.SetParameter("pinnedCpu", std::to_string(this->pinCpu));
+  for (const auto &[name, value] : this->extra)
+    _report.SetParameter(name.substr(2), value);
+}
+
+void BenchmarkOptions::WriteResults(const BenchmarkReport &_report) const
+{
+  if (!this->jsonFile.empty())
+  {
+    std::ofstream jsonStream(this->jsonFile);
+    _report.WriteJson(jsonStream);
+    std::cout << std::endl << "Wrote JSON results to " << this->jsonFile
+      << std::endl;
+  }
+  if (!this->csvFile.empty())
+  {
+    std::ofstream csvStream(this->csvFile);
+    _report.WriteCsv(csvStream);
+    std::cout << std::endl << "Wrote CSV results to " << this->csvFile
+      << std::endl;
+  }
+
+  if (!this->traceFile.empty())
+  {
+#ifdef _SIMPLE_ECM_TRACING
+    std::cout << std::endl << "Trace counters:" << std::endl;
+    for (const auto &[name, value] : Trace::Counters())
+      std::cout << "  " << name << ": " << value << std::endl;
+    std::ofstream traceStream(this->traceFile);
+    Trace::WriteChromeTrace(traceStream);
+    std::cout << std::endl << "Wrote Chrome trace to " << this->traceFile
+      << std::endl;
+#else
+    std::cerr << std::endl << "Tracing is disabled, so no trace was written to "
+      << this->traceFile << " (re-build with -DENABLE_TRACING=ON)"
+      << std::endl;
+#endif // _SIMPLE_ECM_TRACING
+  }
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef BENCHMARK_REPORT_HH_
+#define BENCHMARK_REPORT_HH_
+
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/BenchmarkStats.hh"
+
+/// \brief Collects the results of a benchmark run and writes them in human
+/// readable, JSON or CSV form. Every result is a named metric (for example,
+/// "Each") measured for a named runner, with all times in milliseconds
+class BenchmarkReport
+{
+  /// \brief A single benchmark result
+  public: struct Result
+  {
+    /// \brief The runner that was measured
+    std::string runner;
+
+    /// \brief What was measured
+    std::string metric;
+
+    /// \brief Statistics of the samples that were taken (in milliseconds)
+    BenchmarkStats stats;
+  };
+
+  /// \brief Record a parameter of the benchmark run (entity count, number of
+  /// repetitions, etc.), which is written along with the results
+  /// \param[in] _name The parameter name
+  /// \param[in] _value The parameter value
+  public: void SetParameter(const std::string &_name,
+              const std::string &_value);
+
+  /// \brief Add the samples of a metric for a runner
+  /// \param[in] _runner The runner that was measured
+  /// \param[in] _metric What was measured
+  /// \param[in] _samplesMs The samples, in milliseconds
+  /// \return The result that was recorded
+  public: const Result &Add(const std::string &_runner,
+              const std::string &_metric,
+              const std::vector<double> &_samplesMs);
+
+  /// \brief Get all of the results that have been recorded
+  /// \return The results, in the order they were added
+  public: const std::vector<Result> &Results() const;
+
+  /// \brief Write a single result in human readable form
+  /// \param[in] _os The stream to write to
+  /// \param[in] _result The result
+  public: static void Print(std::ostream &_os, const Result &_result);
+
+  /// \brief Write the parameters and all of the results as JSON
+  /// \param[in] _os The stream to write to
+  public: void WriteJson(std::ostream &_os) const;
+
+  /// \brief Write all of the results as CSV (one row per result)
+  /// \param[in] _os The stream to write to
+  public: void WriteCsv(std::ostream &_os) const;
+
+  /// \brief Escape a string so it can be written as a JSON string
+  /// \param[in] _str The string
+  /// \return The quoted and escaped string
+  private: static std::string JsonString(const std::string &_str);
+
+  /// \brief The parameters of the benchmark run
+  private: std::vector<std::pair<std::string, std::string>> parameters;
+
+  /// \brief The results of the benchmark run
+  private: std::vector<Result> results;
+};
+
+void BenchmarkReport::SetParameter(const std::string &_name,
+    const std::string &_value)
+{
+  for (auto &[name, value] : this->parameters)
+  {
+    if (name == _name)
+    {
+      value = _value;
+      return;
+    }
+  }
+  this->parameters.emplace_back(_name, _value);
+}
+
+const BenchmarkReport::Result &BenchmarkReport::Add(const std::string &_runner,
+    const std::string &_metric, const std::vector<double> &_samplesMs)
+{
+  this->results.push_back({_runner, _metric, ComputeStats(_samplesMs)});
+  return this->results.back();
+}
+
+const std::vector<BenchmarkReport::Result> &BenchmarkReport::Results() const
+{
+  return this->results;
+}
+
+void BenchmarkReport::Print(std::ostream &_os, const Result &_result)
+{
+  const auto &stats = _result.stats;
+  _os << std::left << std::setw(40) << _result.metric << std::right
+    << " n=" << std::setw(5) << stats.samples
+    << std::fixed << std::setprecision(4)
+    << "  min " << std::setw(10) << stats.min
+    << "  median " << std::setw(10) << stats.median
+    << "  p99 " << std::setw(10) << stats.p99
+    << "  stddev " << std::setw(10) << stats.stddev << " ms"
+    << std::defaultfloat << std::endl;
+}
+
+void BenchmarkReport::WriteJson(std::ostream &_os) const
+{
+  _os << std::setprecision(9) << "{\n  \"parameters\": {";
+  for (std::size_t i = 0; i < this->parameters.size(); ++i)
+  {
+    _os << (i ? ",\n" : "\n") << "    "
+      << JsonString(this->parameters[i].first) << ": "
+      << JsonString(this->parameters[i].second);
+  }
+  _os << "\n  },\n  \"results\": [";
+  for (std::size_t i = 0; i < this->results.size(); ++i)
+  {
+    const auto &result = this->results[i];
+    _os << (i ? ",\n" : "\n") << "    {"
+      << "\"runner\": " << JsonString(result.runner)
+      << ", \"metric\": " << JsonString(result.metric)
+      << ", \"samples\": " << result.stats.samples
+      << ", \"min_ms\": " << result.stats.min
+      << ", \"median_ms\": " << result.stats.median
+      << ", \"p99_ms\": " << result.stats.p99
+      << ", \"mean_ms\": " << result.stats.mean
+      << ", \"stddev_ms\": " << result.stats.stddev << "}";
+  }
+  _os << "\n  ]\n}\n";
+}
+
+void BenchmarkReport::WriteCsv(std::ostream &_os) const
+{
+  _os << std::setprecision(9)
+    << "runner,metric,samples,min_ms,median_ms,p99_ms,mean_ms,stddev_ms\n";
+  for (const auto &result : this->results)
+  {
+    _os << result.runner << "," << result.metric << ","
+      << result.stats.samples << "," << result.stats.min << ","
+      << result.stats.median << "," << result.stats.p99 << ","
+      << result.stats.mean << "," << result.stats.stddev << "\n";
+  }
+}
+
+std::string BenchmarkReport::JsonString(const std::string &_str)
+{
+  std::string escaped = "\"";
+  for (const auto c : _str)
+  {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  escaped += "\"";
+  return escaped;
+}
+
+#endif
@@ -3,9 +3,13 @@
 
 #include <cstddef>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <string>
 
+#include "benchmark/EachComponents.hh"
+#include "benchmark/ExtraComponents.hh"
+
 class BenchmarkRunner
 {
   /// \brief Destructor
@@ -17,6 +21,27 @@ class BenchmarkRunner
   /// components added/removed
   public: virtual void Init(const std::size_t _numEntitesToModify) = 0;
 
+  /// \brief Set the number of extra components (see ExtraComponent) that
+  /// MakeEntityWithComponents should attach to every entity, besides the ones
+  /// that EachImplementation iterates over. This should be called before Init
+  /// \param[in] _numExtraComponents The number of extra components
+  /// \return true if the runner supports _numExtraComponents extra
+  /// components, false otherwise
+  public: virtual bool SetExtraComponents(
+              const std::size_t _numExtraComponents);
+
+  /// \brief Make the ECM allocate its storage from memory that is backed by
+  /// huge pages, or stop doing so. This should be called before Init. By
+  /// default, huge pages can't be used
+  /// \param[in] _hugePages Whether huge pages should be used
+  /// \return true if the setting was applied, false if the runner (or
+  /// platform) doesn't support huge pages
+  public: virtual bool SetHugePages(const bool _hugePages);
+
+  /// \brief Get the memory that the ECM mapped for huge pages
+  /// \return The number of bytes, or 0 if the ECM doesn't use huge pages
+  public: virtual std::size_t HugePageBytes() const;
+
   /// \brief Create an entity with components attached to it
   public: virtual void MakeEntityWithComponents() = 0;
 
@@ -31,6 +56,30 @@ class BenchmarkRunner
   /// when calling Init. This should be called after RemoveAComponent
   public: virtual void AddAComponent() = 0;
 
+  /// \brief Create an entity with some of the components that
+  /// EachImplementation iterates over. Entities that are created this way
+  /// are numbered in creation order, starting at 0
+  /// \param[in] _components The components, where bit i is set if the
+  /// entity should have component i (see WithEachComponent)
+  public: virtual void MakeEntityWithComponentSubset(
+              const std::uint16_t _components) = 0;
+
+  /// \brief Add one of the components that EachImplementation iterates over
+  /// to an entity that was created with MakeEntityWithComponentSubset
+  /// \param[in] _entity The entity's number
+  /// \param[in] _component The component (see WithEachComponent), which the
+  /// entity doesn't have
+  public: virtual void AddComponentTo(const std::size_t _entity,
+              const std::size_t _component) = 0;
+
+  /// \brief Remove one of the components that EachImplementation iterates
+  /// over from an entity that was created with MakeEntityWithComponentSubset
+  /// \param[in] _entity The entity's number
+  /// \param[in] _component The component (see WithEachComponent), which the
+  /// entity has
+  public: virtual void RemoveComponentFrom(const std::size_t _entity,
+              const std::size_t _component) = 0;
+
   /// \brief Record the start time of a time interval
   public: void StartTimer();
 
@@ -43,6 +92,10 @@ class BenchmarkRunner
   /// elapsed time. Useful for providing context about the time being displayed
   public: void DisplayElapsedTime(const std::string &_infoMsg = "") const;
 
+  /// \brief Get the time elapsed between the StartTimer and StopTimer calls
+  /// \return The elapsed time, in milliseconds
+  public: double ElapsedMs() const;
+
   /// \brief Verify that the latest EachImplementation call iterated over the
   /// correct number of entities
   /// \param[in] _targetEntityCount The number of entities that should have
@@ -58,6 +111,9 @@ class BenchmarkRunner
   /// \brief The number of entities that should have a component removed/added
   protected: std::size_t numEntitiesToModify{0};
 
+  /// \brief The number of extra components to attach to every entity
+  protected: std::size_t numExtraComponents{0};
+
   /// \brief A time point representing the start of a time interval
   private: std::chrono::time_point<std::chrono::steady_clock> start;
 
@@ -69,6 +125,25 @@ BenchmarkRunner::~BenchmarkRunner()
 {
 }
 
+bool BenchmarkRunner::SetExtraComponents(
+    const std::size_t _numExtraComponents)
+{
+  if (_numExtraComponents > kMaxExtraComponents)
+    return false;
+  this->numExtraComponents = _numExtraComponents;
+  return true;
+}
+
+bool BenchmarkRunner::SetHugePages(const bool _hugePages)
+{
+  return !_hugePages;
+}
+
+std::size_t BenchmarkRunner::HugePageBytes() const
+{
+  return 0;
+}
+
 void BenchmarkRunner::StartTimer()
 {
   this->start = std::chrono::steady_clock::now();
@@ -80,10 +155,15 @@ void BenchmarkRunner::StopTimer()
 }
 
 void BenchmarkRunner::DisplayElapsedTime(const std::string &_infoMsg) const
+{
+  std::cout << _infoMsg << this->ElapsedMs() << " ms" << std::endl;
+}
+
+double BenchmarkRunner::ElapsedMs() const
 {
   const std::chrono::duration<double, std::milli> durationMs =
     this->end - this->start;
-  std::cout << _infoMsg << durationMs.count() << " ms" << std::endl;
+  return durationMs.count();
 }
 
 bool BenchmarkRunner::Valid(const int &_targetEntityCount) const
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "benchmark/BenchmarkRunner.hh"
 #ifdef _ENTT
@@ -13,9 +14,27 @@
   #include "benchmark/IgnGazeboBenchmarkRunner.hh"
 #endif // _IGN_GAZEBO
 #include "benchmark/SimpleECMBenchmarkRunner.hh"
+#include "benchmark/StaticECMBenchmarkRunner.hh"
 
 struct BenchmarkRunnerFactory
 {
+  /// \brief Get all of the BenchmarkRunner types that can be created
+  /// \return The types, which can be passed to Create
+  static std::vector<std::string> Types()
+  {
+    std::vector<std::string> types{"simpleECM", "simpleECM preregistered",
+      "simpleECM group", "simpleECM chunked", "simpleECM query",
+      "simpleECM packed", "staticECM"};
+#ifdef _ENTT
+    types.push_back("entt group");
+    types.push_back("entt view");
+#endif // _ENTT
+#ifdef _IGN_GAZEBO
+    types.push_back("ignGazebo");
+#endif // _IGN_GAZEBO
+    return types;
+  }
+
   /// \brief Create a BenchmarkRunner of a specific type
   /// \param[in] _type The type of BenchmarkRunner to create
   /// \return A pointer to the created BenchmarkRunner. If _type does not
@@ -24,6 +43,33 @@ struct BenchmarkRunnerFactory
   {
     if (_type == "simpleECM")
       return new SimpleECMBenchmarkRunner();
+    else if (_type == "simpleECM preregistered")
+    {
+      return new SimpleECMBenchmarkRunner(
+          SimpleECMBenchmarkRunner::Mode::PreregisteredEach);
+    }
+    else if (_type == "simpleECM group")
+    {
+      return new SimpleECMBenchmarkRunner(
+          SimpleECMBenchmarkRunner::Mode::Group);
+    }
+    else if (_type == "simpleECM chunked")
+    {
+      return new SimpleECMBenchmarkRunner(
+          SimpleECMBenchmarkRunner::Mode::Chunked);
+    }
+    else if (_type == "simpleECM query")
+    {
+      return new SimpleECMBenchmarkRunner(
+          SimpleECMBenchmarkRunner::Mode::Query);
+    }
+    else if (_type == "simpleECM packed")
+    {
+      return new SimpleECMBenchmarkRunner(
+          SimpleECMBenchmarkRunner::Mode::Packed);
+    }
+    else if (_type == "staticECM")
+      return new StaticECMBenchmarkRunner();
 #ifdef _ENTT
     else if (_type == "entt view")
       return new EnttViewBenchmarkRunner();
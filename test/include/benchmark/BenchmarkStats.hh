@@ -0,0 +1,72 @@
+#ifndef BENCHMARK_STATS_HH_
+#define BENCHMARK_STATS_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/// \brief Summary statistics of a set of timing samples
+struct BenchmarkStats
+{
+  /// \brief The number of samples
+  std::size_t samples{0};
+
+  /// \brief The smallest sample
+  double min{0.0};
+
+  /// \brief The median sample
+  double median{0.0};
+
+  /// \brief The 99th percentile sample (nearest-rank)
+  double p99{0.0};
+
+  /// \brief The mean of the samples
+  double mean{0.0};
+
+  /// \brief The sample standard deviation
+  double stddev{0.0};
+};
+
+/// \brief Compute summary statistics for a set of samples
+/// \param[in] _samples The samples
+/// \return The statistics of _samples. If _samples is empty, all statistics
+/// are 0
+BenchmarkStats ComputeStats(std::vector<double> _samples)
+{
+  BenchmarkStats stats;
+  stats.samples = _samples.size();
+  if (_samples.empty())
+    return stats;
+
+  std::sort(_samples.begin(), _samples.end());
+  const auto n = _samples.size();
+
+  stats.min = _samples.front();
+  if (n % 2)
+    stats.median = _samples[n / 2];
+  else
+    stats.median = (_samples[n / 2 - 1] + _samples[n / 2]) / 2.0;
+
+  // nearest-rank percentile: the smallest sample that is >= 99% of samples
+  const auto p99Rank =
+    static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(n)));
+  stats.p99 = _samples[std::max<std::size_t>(p99Rank, 1) - 1];
+
+  double sum = 0.0;
+  for (const auto &sample : _samples)
+    sum += sample;
+  stats.mean = sum / static_cast<double>(n);
+
+  if (n > 1)
+  {
+    double squaredDiffs = 0.0;
+    for (const auto &sample : _samples)
+      squaredDiffs += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = std::sqrt(squaredDiffs / static_cast<double>(n - 1));
+  }
+
+  return stats;
+}
+
+#endif
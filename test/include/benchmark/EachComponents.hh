@@ -0,0 +1,62 @@
+#ifndef EACH_COMPONENTS_HH_
+#define EACH_COMPONENTS_HH_
+
+#include <cstddef>
+
+#include "simpleECM/Components.hh"
+
+/// \brief The number of component types that BenchmarkRunner's
+/// EachImplementation iterates over
+constexpr std::size_t kNumEachComponents{10};
+
+/// \brief Call a function with a default constructed instance of one of the
+/// component types that BenchmarkRunner's EachImplementation iterates over.
+/// The types are numbered in the order that the runners attach them to
+/// entities: Name, Static, LinearVelocity, WorldLinearVelocity,
+/// AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+/// WorldLinearAcceleration, Pose, WorldPose
+/// \param[in] _index The number of the component type, which is less than
+/// kNumEachComponents
+/// \param[in] _f The function, which takes an instance of the component by
+/// value
+template<typename FunctionT>
+void WithEachComponent(const std::size_t _index, FunctionT &&_f)
+{
+  switch (_index)
+  {
+    case 0:
+      _f(Name());
+      break;
+    case 1:
+      _f(Static());
+      break;
+    case 2:
+      _f(LinearVelocity());
+      break;
+    case 3:
+      _f(WorldLinearVelocity());
+      break;
+    case 4:
+      _f(AngularVelocity());
+      break;
+    case 5:
+      _f(WorldAngularVelocity());
+      break;
+    case 6:
+      _f(LinearAcceleration());
+      break;
+    case 7:
+      _f(WorldLinearAcceleration());
+      break;
+    case 8:
+      _f(Pose());
+      break;
+    case 9:
+      _f(WorldPose());
+      break;
+    default:
+      break;
+  }
+}
+
+#endif
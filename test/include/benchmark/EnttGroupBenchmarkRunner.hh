@@ -1,11 +1,14 @@
 #ifndef ENTT_GROUP_BENCHMARK_RUNNER_HH_
 #define ENTT_GROUP_BENCHMARK_RUNNER_HH_
 
+#include <cstdint>
 #include <vector>
 
 #include <entt/entity/registry.hpp>
 
 #include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/EachComponents.hh"
+#include "benchmark/ExtraComponents.hh"
 #include "simpleECM/Components.hh"
 
 class EnttGroupBenchmarkRunner : public BenchmarkRunner
@@ -25,12 +28,28 @@ class EnttGroupBenchmarkRunner : public BenchmarkRunner
   /// \brief Documentation inherited
   public: void AddAComponent() final;
 
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponentSubset(const std::uint16_t _components)
+              final;
+
+  /// \brief Documentation inherited
+  public: void AddComponentTo(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveComponentFrom(const std::size_t _entity,
+              const std::size_t _component) final;
+
   /// \brief Entt registry, which is like an ECM
   private: entt::registry registry;
 
   /// \brief Keep track of the entities that should have a component removed or
   /// added
   private: std::vector<entt::entity> entitiesToModify;
+
+  /// \brief The entities that were created with
+  /// MakeEntityWithComponentSubset, in creation order
+  private: std::vector<entt::entity> subsetEntities;
 };
 
 void EnttGroupBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
@@ -51,6 +70,11 @@ void EnttGroupBenchmarkRunner::MakeEntityWithComponents()
   this->registry.emplace<WorldLinearAcceleration>(entity);
   this->registry.emplace<Pose>(entity);
   this->registry.emplace<WorldPose>(entity);
+  ForEachExtraComponent(this->numExtraComponents,
+      [this, entity](auto _component)
+      {
+        this->registry.emplace<decltype(_component)>(entity, _component);
+      });
 
   if (this->entitiesToModify.size() < this->numEntitiesToModify)
     this->entitiesToModify.push_back(entity);
@@ -119,4 +143,40 @@ void EnttGroupBenchmarkRunner::AddAComponent()
     this->registry.emplace<LinearVelocity>(entity);
 }
 
+void EnttGroupBenchmarkRunner::MakeEntityWithComponentSubset(
+    const std::uint16_t _components)
+{
+  const auto entity = this->registry.create();
+  for (std::size_t i = 0; i < kNumEachComponents; ++i)
+  {
+    if (!(_components & (1u << i)))
+      continue;
+    WithEachComponent(i, [this, entity](auto _instance)
+        {
+          this->registry.emplace<decltype(_instance)>(entity, _instance);
+        });
+  }
+  this->subsetEntities.push_back(entity);
+}
+
+void EnttGroupBenchmarkRunner::AddComponentTo(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->registry.emplace<decltype(_instance)>(entity, _instance);
+      });
+}
+
+void EnttGroupBenchmarkRunner::RemoveComponentFrom(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->registry.remove<decltype(_instance)>(entity);
+      });
+}
+
 #endif
@@ -0,0 +1,59 @@
+#ifndef EXTRA_COMPONENTS_HH_
+#define EXTRA_COMPONENTS_HH_
+
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+#include "simpleECM/Components.hh"
+#include "simpleECM/Types.hh"
+
+/// \brief A component that benchmarks attach to entities but never iterate
+/// over, which makes it possible to vary the number of components per entity
+/// \tparam Index Which extra component this is, in [0, kMaxExtraComponents)
+template<std::size_t Index>
+struct ExtraComponent : public BaseComponent
+{
+  private: std::ostream &ToOStream(std::ostream &_os) const
+  {
+    _os << this->data;
+    return _os;
+  }
+
+  public: ComponentTypeId DerivedTypeId() const
+  {
+    return this->typeId;
+  }
+
+  public: double data{0.0};
+  public: constexpr const static ComponentTypeId typeId{100 + Index};
+  public: constexpr const static char *typeName{"ExtraComponent"};
+};
+
+/// \brief The number of extra component types
+constexpr std::size_t kMaxExtraComponents{8};
+
+/// \brief Implementation of ForEachExtraComponent
+/// \param[in] _count The number of extra component types
+/// \param[in] _f The function
+template<typename FunctionT, std::size_t ...Indices>
+void ForEachExtraComponentImpl(const std::size_t _count, FunctionT &&_f,
+    std::index_sequence<Indices...>)
+{
+  ((Indices < _count ? _f(ExtraComponent<Indices>()) : void()), ...);
+}
+
+/// \brief Call a function with a default constructed instance of each of the
+/// first _count extra component types
+/// \param[in] _count The number of extra component types, which is at most
+/// kMaxExtraComponents
+/// \param[in] _f The function, which takes an instance of an extra component
+/// by value
+template<typename FunctionT>
+void ForEachExtraComponent(const std::size_t _count, FunctionT &&_f)
+{
+  ForEachExtraComponentImpl(_count, std::forward<FunctionT>(_f),
+      std::make_index_sequence<kMaxExtraComponents>());
+}
+
+#endif
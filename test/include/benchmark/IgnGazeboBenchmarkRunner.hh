@@ -1,6 +1,7 @@
 #ifndef IGN_GAZEBO_BENCHMARK_RUNNER_HH_
 #define IGN_GAZEBO_BENCHMARK_RUNNER_HH_
 
+#include <cstdint>
 #include <vector>
 
 #include <ignition/gazebo/Entity.hh>
@@ -13,12 +14,18 @@
 #include <ignition/gazebo/components/Static.hh>
 
 #include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/EachComponents.hh"
 
 class IgnGazeboBenchmarkRunner : public BenchmarkRunner
 {
   /// \brief Documentation inherited
   public: void Init(const std::size_t _numEntitiesToModify) final;
 
+  /// \brief Documentation inherited. Extra components aren't registered with
+  /// Gazebo, so they aren't supported
+  public: bool SetExtraComponents(const std::size_t _numExtraComponents)
+              final;
+
   /// \brief Documentation inherited
   public: void MakeEntityWithComponents() final;
 
@@ -31,12 +38,39 @@ class IgnGazeboBenchmarkRunner : public BenchmarkRunner
   /// \brief Documentation inherited
   public: void AddAComponent() final;
 
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponentSubset(const std::uint16_t _components)
+              final;
+
+  /// \brief Documentation inherited
+  public: void AddComponentTo(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveComponentFrom(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief Call a function with a default constructed instance of the
+  /// Gazebo component that corresponds to one of the components in
+  /// WithEachComponent
+  /// \param[in] _index The number of the component type (see
+  /// WithEachComponent)
+  /// \param[in] _f The function, which takes an instance of the component by
+  /// value
+  private: template<typename FunctionT>
+           static void WithGazeboComponent(const std::size_t _index,
+               FunctionT &&_f);
+
   /// \brief ECM
   private: ignition::gazebo::EntityComponentManager ecm;
 
   /// \brief Keep track of the entities that should have a component removed
   /// or added
   private: std::vector<ignition::gazebo::Entity> entitiesToModify;
+
+  /// \brief The entities that were created with
+  /// MakeEntityWithComponentSubset, in creation order
+  private: std::vector<ignition::gazebo::Entity> subsetEntities;
 };
 
 void IgnGazeboBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
@@ -44,6 +78,12 @@ void IgnGazeboBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
   this->numEntitiesToModify = _numEntitiesToModify;
 }
 
+bool IgnGazeboBenchmarkRunner::SetExtraComponents(
+    const std::size_t _numExtraComponents)
+{
+  return _numExtraComponents == 0;
+}
+
 void IgnGazeboBenchmarkRunner::MakeEntityWithComponents()
 {
   using namespace ignition::gazebo;
@@ -109,4 +149,84 @@ void IgnGazeboBenchmarkRunner::AddAComponent()
   }
 }
 
+
+void IgnGazeboBenchmarkRunner::MakeEntityWithComponentSubset(
+    const std::uint16_t _components)
+{
+  const auto entity = this->ecm.CreateEntity();
+  for (std::size_t i = 0; i < kNumEachComponents; ++i)
+  {
+    if (!(_components & (1u << i)))
+      continue;
+    WithGazeboComponent(i, [this, entity](auto _instance)
+        {
+          this->ecm.CreateComponent(entity, _instance);
+        });
+  }
+  this->subsetEntities.push_back(entity);
+}
+
+void IgnGazeboBenchmarkRunner::AddComponentTo(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithGazeboComponent(_component, [this, entity](auto _instance)
+      {
+        this->ecm.CreateComponent(entity, _instance);
+      });
+}
+
+void IgnGazeboBenchmarkRunner::RemoveComponentFrom(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithGazeboComponent(_component, [this, entity](auto _instance)
+      {
+        this->ecm.RemoveComponent<decltype(_instance)>(entity);
+      });
+}
+
+template<typename FunctionT>
+void IgnGazeboBenchmarkRunner::WithGazeboComponent(const std::size_t _index,
+    FunctionT &&_f)
+{
+  using namespace ignition::gazebo;
+
+  switch (_index)
+  {
+    case 0:
+      _f(components::Name());
+      break;
+    case 1:
+      _f(components::Static());
+      break;
+    case 2:
+      _f(components::LinearVelocity());
+      break;
+    case 3:
+      _f(components::WorldLinearVelocity());
+      break;
+    case 4:
+      _f(components::AngularVelocity());
+      break;
+    case 5:
+      _f(components::WorldAngularVelocity());
+      break;
+    case 6:
+      _f(components::LinearAcceleration());
+      break;
+    case 7:
+      _f(components::WorldLinearAcceleration());
+      break;
+    case 8:
+      _f(components::Pose());
+      break;
+    case 9:
+      _f(components::WorldPose());
+      break;
+    default:
+      break;
+  }
+}
+
 #endif
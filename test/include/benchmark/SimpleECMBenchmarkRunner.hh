@@ -2,18 +2,56 @@
 #define SIMPLE_ECM_BENCHMARK_RUNNER_HH_
 
 #include <functional>
+#include <cstdint>
 #include <vector>
 
 #include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/EachComponents.hh"
+#include "benchmark/ExtraComponents.hh"
 #include "simpleECM/Components.hh"
 #include "simpleECM/Ecm.hh"
 #include "simpleECM/Types.hh"
 
 class SimpleECMBenchmarkRunner : public BenchmarkRunner
 {
+  /// \brief The ways the simple ECM can be used to iterate over entities
+  public: enum class Mode
+  {
+    /// \brief Call Each(...), which creates the view on first use
+    Each,
+
+    /// \brief Register the view before entities are created, and then call
+    /// Each(...)
+    PreregisteredEach,
+
+    /// \brief Create an owning group for all of the components before
+    /// entities are created, and then call Each(...)
+    Group,
+
+    /// \brief Call EachChunk(...), which iterates over blocks of entities
+    Chunked,
+
+    /// \brief Iterate over Query(...) with a range-based for loop
+    Query,
+
+    /// \brief Make the view packed (see ECM::SetViewPacked) before entities
+    /// are created, and then call Each(...)
+    Packed
+  };
+
+  /// \brief Constructor
+  /// \param[in] _mode How the simple ECM should be used
+  public: explicit SimpleECMBenchmarkRunner(const Mode _mode = Mode::Each);
+
   /// \brief Documentation inherited
   public: void Init(const std::size_t _numEntitiesToModify) final;
 
+  /// \brief Documentation inherited
+  public: bool SetHugePages(const bool _hugePages) final;
+
+  /// \brief Documentation inherited
+  public: std::size_t HugePageBytes() const final;
+
   /// \brief Documentation inherited
   public: void MakeEntityWithComponents() final;
 
@@ -26,6 +64,21 @@ class SimpleECMBenchmarkRunner : public BenchmarkRunner
   /// \brief Documentation inherited
   public: void AddAComponent() final;
 
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponentSubset(const std::uint16_t _components)
+              final;
+
+  /// \brief Documentation inherited
+  public: void AddComponentTo(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveComponentFrom(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief How the simple ECM is used
+  private: Mode mode;
+
   /// \brief The ECM that is being benchmarked
   private: ECM simpleEcm;
 
@@ -46,15 +99,93 @@ class SimpleECMBenchmarkRunner : public BenchmarkRunner
   /// \brief Callback function that is used in EachImplementation
   private: AllComponentEachFunc findAllComponents;
 
+  /// \brief The callback function signature used for the ECM's
+  /// EachChunk(...) call
+  private: using AllComponentChunkFunc =
+            std::function<bool(Span<const Entity>,
+                               Span<Name>,
+                               Span<Static>,
+                               Span<LinearVelocity>,
+                               Span<WorldLinearVelocity>,
+                               Span<AngularVelocity>,
+                               Span<WorldAngularVelocity>,
+                               Span<LinearAcceleration>,
+                               Span<WorldLinearAcceleration>,
+                               Span<Pose>,
+                               Span<WorldPose>)>;
+
+  /// \brief Callback function that is used in EachImplementation in chunked
+  /// mode
+  private: AllComponentChunkFunc findAllComponentChunks;
+
   /// \brief Keep track of the entities that should have a component removed
   /// or added
   private: std::vector<Entity> entitiesToModify;
+
+  /// \brief The entities that were created with
+  /// MakeEntityWithComponentSubset, in creation order
+  private: std::vector<Entity> subsetEntities;
 };
 
+SimpleECMBenchmarkRunner::SimpleECMBenchmarkRunner(const Mode _mode)
+  : mode(_mode)
+{
+}
+
+bool SimpleECMBenchmarkRunner::SetHugePages(const bool _hugePages)
+{
+  return this->simpleEcm.SetHugePages(_hugePages);
+}
+
+std::size_t SimpleECMBenchmarkRunner::HugePageBytes() const
+{
+  return this->simpleEcm.MemoryStats().HugePageBytes();
+}
+
 void SimpleECMBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
 {
   this->numEntitiesToModify = _numEntitiesToModify;
 
+  if (this->mode == Mode::PreregisteredEach)
+  {
+    this->simpleEcm.RegisterView<Name,
+                                 Static,
+                                 LinearVelocity,
+                                 WorldLinearVelocity,
+                                 AngularVelocity,
+                                 WorldAngularVelocity,
+                                 LinearAcceleration,
+                                 WorldLinearAcceleration,
+                                 Pose,
+                                 WorldPose>();
+  }
+  else if (this->mode == Mode::Packed)
+  {
+    this->simpleEcm.SetViewPacked<Name,
+                                  Static,
+                                  LinearVelocity,
+                                  WorldLinearVelocity,
+                                  AngularVelocity,
+                                  WorldAngularVelocity,
+                                  LinearAcceleration,
+                                  WorldLinearAcceleration,
+                                  Pose,
+                                  WorldPose>(true);
+  }
+  else if (this->mode == Mode::Group)
+  {
+    this->simpleEcm.CreateGroup<Name,
+                                Static,
+                                LinearVelocity,
+                                WorldLinearVelocity,
+                                AngularVelocity,
+                                WorldAngularVelocity,
+                                LinearAcceleration,
+                                WorldLinearAcceleration,
+                                Pose,
+                                WorldPose>();
+  }
+
   this->findAllComponents =
     [this](const Entity &,
            Name *,
@@ -71,6 +202,23 @@ void SimpleECMBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
       this->entityCount++;
       return true;
     };
+
+  this->findAllComponentChunks =
+    [this](Span<const Entity> _entities,
+           Span<Name>,
+           Span<Static>,
+           Span<LinearVelocity>,
+           Span<WorldLinearVelocity>,
+           Span<AngularVelocity>,
+           Span<WorldAngularVelocity>,
+           Span<LinearAcceleration>,
+           Span<WorldLinearAcceleration>,
+           Span<Pose>,
+           Span<WorldPose>) -> bool
+    {
+      this->entityCount += static_cast<int>(_entities.size());
+      return true;
+    };
 }
 
 void SimpleECMBenchmarkRunner::MakeEntityWithComponents()
@@ -86,6 +234,11 @@ void SimpleECMBenchmarkRunner::MakeEntityWithComponents()
   this->simpleEcm.AddComponent(entity, WorldLinearAcceleration());
   this->simpleEcm.AddComponent(entity, Pose());
   this->simpleEcm.AddComponent(entity, WorldPose());
+  ForEachExtraComponent(this->numExtraComponents,
+      [this, entity](auto _component)
+      {
+        this->simpleEcm.AddComponent(entity, _component);
+      });
 
   if (this->entitiesToModify.size() < this->numEntitiesToModify)
     this->entitiesToModify.push_back(entity);
@@ -94,7 +247,30 @@ void SimpleECMBenchmarkRunner::MakeEntityWithComponents()
 void SimpleECMBenchmarkRunner::EachImplementation()
 {
   this->entityCount = 0;
-  this->simpleEcm.Each(this->findAllComponents);
+  if (this->mode == Mode::Chunked)
+    this->simpleEcm.EachChunk(this->findAllComponentChunks);
+  else if (this->mode == Mode::Query)
+  {
+    for (const auto &[entity, name, isStatic, linVel, worldLinVel, angVel,
+          worldAngVel, linAccel, worldLinAccel, pose, worldPose] :
+         this->simpleEcm.Query<Name,
+                               Static,
+                               LinearVelocity,
+                               WorldLinearVelocity,
+                               AngularVelocity,
+                               WorldAngularVelocity,
+                               LinearAcceleration,
+                               WorldLinearAcceleration,
+                               Pose,
+                               WorldPose>())
+    {
+      // the entity is checked so that the loop still reads every row
+      if (entity != kNullEntity)
+        this->entityCount++;
+    }
+  }
+  else
+    this->simpleEcm.Each(this->findAllComponents);
 }
 
 void SimpleECMBenchmarkRunner::RemoveAComponent()
@@ -109,4 +285,40 @@ void SimpleECMBenchmarkRunner::AddAComponent()
     this->simpleEcm.AddComponent(entity, LinearVelocity());
 }
 
+void SimpleECMBenchmarkRunner::MakeEntityWithComponentSubset(
+    const std::uint16_t _components)
+{
+  const auto entity = this->simpleEcm.CreateEntity();
+  for (std::size_t i = 0; i < kNumEachComponents; ++i)
+  {
+    if (!(_components & (1u << i)))
+      continue;
+    WithEachComponent(i, [this, entity](auto _instance)
+        {
+          this->simpleEcm.AddComponent(entity, _instance);
+        });
+  }
+  this->subsetEntities.push_back(entity);
+}
+
+void SimpleECMBenchmarkRunner::AddComponentTo(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->simpleEcm.AddComponent(entity, _instance);
+      });
+}
+
+void SimpleECMBenchmarkRunner::RemoveComponentFrom(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->simpleEcm.RemoveComponent<decltype(_instance)>(entity);
+      });
+}
+
 #endif
@@ -0,0 +1,190 @@
+#ifndef STATIC_ECM_BENCHMARK_RUNNER_HH_
+#define STATIC_ECM_BENCHMARK_RUNNER_HH_
+
+#include <functional>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/BenchmarkRunner.hh"
+#include "benchmark/EachComponents.hh"
+#include "benchmark/ExtraComponents.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/StaticEcm.hh"
+#include "simpleECM/Types.hh"
+
+class StaticECMBenchmarkRunner : public BenchmarkRunner
+{
+  /// \brief Documentation inherited
+  public: void Init(const std::size_t _numEntitiesToModify) final;
+
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponents() final;
+
+  /// \brief Documentation inherited
+  public: void EachImplementation() final;
+
+  /// \brief Documentation inherited
+  public: void RemoveAComponent() final;
+
+  /// \brief Documentation inherited
+  public: void AddAComponent() final;
+
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponentSubset(const std::uint16_t _components)
+              final;
+
+  /// \brief Documentation inherited
+  public: void AddComponentTo(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveComponentFrom(const std::size_t _entity,
+              const std::size_t _component) final;
+
+  /// \brief The ECM that is being benchmarked, whose schema is every
+  /// component type that the benchmark uses (including the extra components)
+  private: StaticECM<Name,
+                     Static,
+                     LinearVelocity,
+                     WorldLinearVelocity,
+                     AngularVelocity,
+                     WorldAngularVelocity,
+                     LinearAcceleration,
+                     WorldLinearAcceleration,
+                     Pose,
+                     WorldPose,
+                     ExtraComponent<0>,
+                     ExtraComponent<1>,
+                     ExtraComponent<2>,
+                     ExtraComponent<3>,
+                     ExtraComponent<4>,
+                     ExtraComponent<5>,
+                     ExtraComponent<6>,
+                     ExtraComponent<7>> staticEcm;
+
+  /// \brief The callback function signature used for the ECM's Each(...) call
+  private: using AllComponentEachFunc =
+            std::function<bool(const Entity &,
+                               Name *,
+                               Static *,
+                               LinearVelocity *,
+                               WorldLinearVelocity *,
+                               AngularVelocity *,
+                               WorldAngularVelocity *,
+                               LinearAcceleration *,
+                               WorldLinearAcceleration *,
+                               Pose *,
+                               WorldPose *)>;
+
+  /// \brief Callback function that is used in EachImplementation
+  private: AllComponentEachFunc findAllComponents;
+
+  /// \brief Keep track of the entities that should have a component removed
+  /// or added
+  private: std::vector<Entity> entitiesToModify;
+
+  /// \brief The entities that were created with
+  /// MakeEntityWithComponentSubset, in creation order
+  private: std::vector<Entity> subsetEntities;
+};
+
+void StaticECMBenchmarkRunner::Init(const std::size_t _numEntitiesToModify)
+{
+  this->numEntitiesToModify = _numEntitiesToModify;
+
+  this->findAllComponents =
+    [this](const Entity &,
+           Name *,
+           Static *,
+           LinearVelocity *,
+           WorldLinearVelocity *,
+           AngularVelocity *,
+           WorldAngularVelocity *,
+           LinearAcceleration *,
+           WorldLinearAcceleration *,
+           Pose *,
+           WorldPose *) -> bool
+    {
+      this->entityCount++;
+      return true;
+    };
+}
+
+void StaticECMBenchmarkRunner::MakeEntityWithComponents()
+{
+  const auto entity = this->staticEcm.CreateEntity();
+  this->staticEcm.AddComponent(entity, Name());
+  this->staticEcm.AddComponent(entity, Static());
+  this->staticEcm.AddComponent(entity, LinearVelocity());
+  this->staticEcm.AddComponent(entity, WorldLinearVelocity());
+  this->staticEcm.AddComponent(entity, AngularVelocity());
+  this->staticEcm.AddComponent(entity, WorldAngularVelocity());
+  this->staticEcm.AddComponent(entity, LinearAcceleration());
+  this->staticEcm.AddComponent(entity, WorldLinearAcceleration());
+  this->staticEcm.AddComponent(entity, Pose());
+  this->staticEcm.AddComponent(entity, WorldPose());
+  ForEachExtraComponent(this->numExtraComponents,
+      [this, entity](auto _component)
+      {
+        this->staticEcm.AddComponent(entity, _component);
+      });
+
+  if (this->entitiesToModify.size() < this->numEntitiesToModify)
+    this->entitiesToModify.push_back(entity);
+}
+
+void StaticECMBenchmarkRunner::EachImplementation()
+{
+  this->entityCount = 0;
+  this->staticEcm.Each(this->findAllComponents);
+}
+
+void StaticECMBenchmarkRunner::RemoveAComponent()
+{
+  for (auto &entity : this->entitiesToModify)
+    this->staticEcm.RemoveComponent<LinearVelocity>(entity);
+}
+
+void StaticECMBenchmarkRunner::AddAComponent()
+{
+  for (auto &entity : this->entitiesToModify)
+    this->staticEcm.AddComponent(entity, LinearVelocity());
+}
+
+void StaticECMBenchmarkRunner::MakeEntityWithComponentSubset(
+    const std::uint16_t _components)
+{
+  const auto entity = this->staticEcm.CreateEntity();
+  for (std::size_t i = 0; i < kNumEachComponents; ++i)
+  {
+    if (!(_components & (1u << i)))
+      continue;
+    WithEachComponent(i, [this, entity](auto _instance)
+        {
+          this->staticEcm.AddComponent(entity, _instance);
+        });
+  }
+  this->subsetEntities.push_back(entity);
+}
+
+void StaticECMBenchmarkRunner::AddComponentTo(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->staticEcm.AddComponent(entity, _instance);
+      });
+}
+
+void StaticECMBenchmarkRunner::RemoveComponentFrom(const std::size_t _entity,
+    const std::size_t _component)
+{
+  const auto entity = this->subsetEntities[_entity];
+  WithEachComponent(_component, [this, entity](auto _instance)
+      {
+        this->staticEcm.RemoveComponent<decltype(_instance)>(entity);
+      });
+}
+
+#endif
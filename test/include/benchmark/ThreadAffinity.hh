@@ -0,0 +1,30 @@
+#ifndef THREAD_AFFINITY_HH_
+#define THREAD_AFFINITY_HH_
+
+#include <iostream>
+
+#ifdef __linux__
+  #include <sched.h>
+#endif // __linux__
+
+/// \brief Pin the calling thread to a single CPU, which reduces timing noise
+/// caused by the thread migrating between CPUs
+/// \param[in] _cpu The CPU to run on
+/// \return true if the thread was pinned, false otherwise
+bool PinCurrentThread(const int _cpu)
+{
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(_cpu, &cpuSet);
+  if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+    return true;
+  std::cerr << "Unable to pin the current thread to CPU " << _cpu << std::endl;
+#else
+  std::cerr << "Thread pinning is only supported on Linux, so CPU " << _cpu
+    << " will not be used exclusively" << std::endl;
+#endif // __linux__
+  return false;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef ENTT_MEMORY_RUNNER_HH_
+#define ENTT_MEMORY_RUNNER_HH_
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <entt/entity/registry.hpp>
+
+#include "memory/MemoryRunner.hh"
+#include "memory/ViewPermutations.hh"
+#include "simpleECM/Components.hh"
+
+class EnttMemoryRunner : public MemoryRunner
+{
+  /// \brief Documentation inherited
+  public: void MakeEntityWithComponents() final;
+
+  /// \brief Documentation inherited
+  public: void Run() final;
+
+  /// \brief Documentation inherited. EnTT views are built on the fly, so
+  /// non-owning groups (which are kept up to date as components are added
+  /// and removed) are registered instead
+  public: bool RegisterViews(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveAComponent(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void AddAComponent(const std::size_t _count) final;
+
+  /// \brief Register a non-owning group of some of the components
+  /// \tparam Indices The component numbers (see kNumViewComponents)
+  private: template<std::size_t ...Indices>
+           void RegisterGroup(std::index_sequence<Indices...>);
+
+  /// \brief The component types, in the order of their numbers (see
+  /// kNumViewComponents)
+  private: using ComponentTypes = std::tuple<Name,
+                                             Static,
+                                             LinearVelocity,
+                                             WorldLinearVelocity,
+                                             AngularVelocity,
+                                             WorldAngularVelocity,
+                                             LinearAcceleration,
+                                             WorldLinearAcceleration,
+                                             Pose,
+                                             WorldPose>;
+
+  /// \brief Entt registry, which is like an ECM
+  private: entt::registry registry;
+
+  /// \brief The entities that were created with MakeEntityWithComponents
+  private: std::vector<entt::entity> entities;
+};
+
+void EnttMemoryRunner::MakeEntityWithComponents()
+{
+  const auto entity = this->registry.create();
+  this->registry.emplace<Name>(entity);
+  this->registry.emplace<Static>(entity);
+  this->registry.emplace<LinearVelocity>(entity);
+  this->registry.emplace<WorldLinearVelocity>(entity);
+  this->registry.emplace<AngularVelocity>(entity);
+  this->registry.emplace<WorldAngularVelocity>(entity);
+  this->registry.emplace<LinearAcceleration>(entity);
+  this->registry.emplace<WorldLinearAcceleration>(entity);
+  this->registry.emplace<Pose>(entity);
+  this->registry.emplace<WorldPose>(entity);
+  this->entities.push_back(entity);
+}
+
+void EnttMemoryRunner::Run()
+{
+  // use the same component combinations (and orderings) as the other memory
+  // runners. EnTT views are built on the fly from the component pools, so
+  // none of these calls should allocate memory that outlives the call
+  const auto noOp = [](const auto /*_entity*/, auto &.../*_components*/) {};
+
+  this->registry.view<Name>().each(noOp);
+  this->registry.view<Name, Static>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity,
+    WorldLinearVelocity>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity, LinearAcceleration>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+    WorldLinearAcceleration>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+    WorldLinearAcceleration, Pose>().each(noOp);
+  this->registry.view<Name, Static, LinearVelocity, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+    WorldLinearAcceleration, Pose, WorldPose>().each(noOp);
+
+  this->registry.view<Static, Name>().each(noOp);
+  this->registry.view<Static, Name, LinearVelocity>().each(noOp);
+  this->registry.view<Name, LinearVelocity, Static>().each(noOp);
+  this->registry.view<Static, LinearVelocity, Name, WorldLinearVelocity,
+    AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+    WorldLinearAcceleration, Pose, WorldPose>().each(noOp);
+}
+
+bool EnttMemoryRunner::RegisterViews(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    WithViewPermutation(i, [this](auto _components)
+        {
+          this->RegisterGroup(_components);
+        });
+  }
+  return true;
+}
+
+void EnttMemoryRunner::RemoveAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+    this->registry.remove<LinearVelocity>(this->entities[i]);
+}
+
+void EnttMemoryRunner::AddAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+    this->registry.emplace<LinearVelocity>(this->entities[i]);
+}
+
+template<std::size_t ...Indices>
+void EnttMemoryRunner::RegisterGroup(std::index_sequence<Indices...>)
+{
+  // a single component is iterated over through its storage, so there is
+  // nothing to register (and EnTT doesn't allow single component groups)
+  if constexpr (sizeof...(Indices) > 1)
+  {
+    this->registry.group<>(
+        entt::get<std::tuple_element_t<Indices, ComponentTypes>...>);
+  }
+}
+#endif
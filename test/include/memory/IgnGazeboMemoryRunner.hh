@@ -1,6 +1,11 @@
 #ifndef IGN_GAZEBO_MEMORY_RUNNER_HH_
 #define IGN_GAZEBO_MEMORY_RUNNER_HH_
 
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <ignition/gazebo/Entity.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
 #include <ignition/gazebo/components/AngularVelocity.hh>
@@ -11,6 +16,7 @@
 #include <ignition/gazebo/components/Static.hh>
 
 #include "memory/MemoryRunner.hh"
+#include "memory/ViewPermutations.hh"
 
 class IgnGazeboMemoryRunner : public MemoryRunner
 {
@@ -20,8 +26,41 @@ class IgnGazeboMemoryRunner : public MemoryRunner
   /// \brief Documentation inherited
   public: void Run() final;
 
+  /// \brief Documentation inherited. Gazebo creates a view the first time
+  /// Each(...) is called with a set of components, so a view is registered
+  /// by calling Each(...)
+  public: bool RegisterViews(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveAComponent(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void AddAComponent(const std::size_t _count) final;
+
+  /// \brief Create the view of some of the components
+  /// \tparam Indices The component numbers (see kNumViewComponents)
+  private: template<std::size_t ...Indices>
+           void RegisterView(std::index_sequence<Indices...>);
+
+  /// \brief The component types, in the order of their numbers (see
+  /// kNumViewComponents)
+  private: using ComponentTypes =
+             std::tuple<ignition::gazebo::components::Name,
+                        ignition::gazebo::components::Static,
+                        ignition::gazebo::components::LinearVelocity,
+                        ignition::gazebo::components::WorldLinearVelocity,
+                        ignition::gazebo::components::AngularVelocity,
+                        ignition::gazebo::components::WorldAngularVelocity,
+                        ignition::gazebo::components::LinearAcceleration,
+                        ignition::gazebo::components::WorldLinearAcceleration,
+                        ignition::gazebo::components::Pose,
+                        ignition::gazebo::components::WorldPose>;
+
   /// \brief The ECM that is being tested for memory usage
   private: ignition::gazebo::EntityComponentManager ecm;
+
+  /// \brief The entities that were created with MakeEntityWithComponents
+  private: std::vector<ignition::gazebo::Entity> entities;
 };
 
 void IgnGazeboMemoryRunner::MakeEntityWithComponents()
@@ -39,6 +78,7 @@ void IgnGazeboMemoryRunner::MakeEntityWithComponents()
   this->ecm.CreateComponent(entity, components::WorldLinearAcceleration());
   this->ecm.CreateComponent(entity, components::Pose());
   this->ecm.CreateComponent(entity, components::WorldPose());
+  this->entities.push_back(entity);
 }
 
 void IgnGazeboMemoryRunner::Run()
@@ -196,4 +236,44 @@ void IgnGazeboMemoryRunner::Run()
       });
 }
 
+bool IgnGazeboMemoryRunner::RegisterViews(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    WithViewPermutation(i, [this](auto _components)
+        {
+          this->RegisterView(_components);
+        });
+  }
+  return true;
+}
+
+void IgnGazeboMemoryRunner::RemoveAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    this->ecm.RemoveComponent<ignition::gazebo::components::LinearVelocity>(
+        this->entities[i]);
+  }
+}
+
+void IgnGazeboMemoryRunner::AddAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    this->ecm.CreateComponent(this->entities[i],
+        ignition::gazebo::components::LinearVelocity());
+  }
+}
+
+template<std::size_t ...Indices>
+void IgnGazeboMemoryRunner::RegisterView(std::index_sequence<Indices...>)
+{
+  this->ecm.Each<std::tuple_element_t<Indices, ComponentTypes>...>(
+      [](const ignition::gazebo::Entity &,
+         std::tuple_element_t<Indices, ComponentTypes> *...)
+      {
+        return true;
+      });
+}
 #endif
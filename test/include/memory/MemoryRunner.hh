@@ -1,6 +1,9 @@
 #ifndef MEMORY_RUNNER_HH_
 #define MEMORY_RUNNER_HH_
 
+#include <cstddef>
+#include <ostream>
+
 class MemoryRunner
 {
   /// \brief Destructor
@@ -11,10 +14,79 @@ class MemoryRunner
 
   /// \brief Run a potentially memory-intensive operation
   public: virtual void Run() = 0;
+
+  /// \brief Register views that are kept up to date as components are added
+  /// and removed, each for a different combination or ordering of components
+  /// (see NthViewPermutation). By default, nothing is registered (not every
+  /// implementation keeps views)
+  /// \param[in] _count The number of views, which is at most
+  /// kMaxViewPermutations
+  /// \return true if the views were registered, false if the implementation
+  /// doesn't keep views
+  public: virtual bool RegisterViews(const std::size_t _count);
+
+  /// \brief Remove the LinearVelocity component from the first entities that
+  /// were created with MakeEntityWithComponents
+  /// \param[in] _count The number of entities
+  public: virtual void RemoveAComponent(const std::size_t _count) = 0;
+
+  /// \brief Add the LinearVelocity component back to the first entities that
+  /// were created with MakeEntityWithComponents. This should be called after
+  /// RemoveAComponent
+  /// \param[in] _count The number of entities
+  public: virtual void AddAComponent(const std::size_t _count) = 0;
+
+  /// \brief Get the memory used by views, as reported by the ECM
+  /// implementation itself
+  /// \return The number of bytes, or 0 if the implementation can't report
+  /// it
+  public: virtual std::size_t ViewBytes() const;
+
+  /// \brief Make the ECM allocate its storage from memory that is backed by
+  /// huge pages, or stop doing so. This should be called before entities are
+  /// created. By default, huge pages can't be used
+  /// \param[in] _hugePages Whether huge pages should be used
+  /// \return true if the setting was applied, false if the implementation
+  /// (or platform) doesn't support huge pages
+  public: virtual bool SetHugePages(const bool _hugePages);
+
+  /// \brief Get the memory that the ECM mapped for huge pages
+  /// \return The number of bytes, or 0 if the ECM doesn't use huge pages
+  public: virtual std::size_t HugePageBytes() const;
+
+  /// \brief Write the memory usage reported by the ECM implementation itself.
+  /// By default, nothing is written (not every implementation can report its
+  /// memory usage)
+  /// \param[in] _os The stream to write to
+  public: virtual void PrintStats(std::ostream &_os) const;
 };
 
 MemoryRunner::~MemoryRunner()
 {
 }
 
+void MemoryRunner::PrintStats(std::ostream &) const
+{
+}
+
+bool MemoryRunner::RegisterViews(const std::size_t)
+{
+  return false;
+}
+
+std::size_t MemoryRunner::ViewBytes() const
+{
+  return 0;
+}
+
+bool MemoryRunner::SetHugePages(const bool _hugePages)
+{
+  return !_hugePages;
+}
+
+std::size_t MemoryRunner::HugePageBytes() const
+{
+  return 0;
+}
+
 #endif
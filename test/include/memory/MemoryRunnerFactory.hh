@@ -3,8 +3,12 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "memory/MemoryRunner.hh"
+#ifdef _ENTT
+  #include "memory/EnttMemoryRunner.hh"
+#endif // _ENTT
 #ifdef _IGN_GAZEBO
   #include "memory/IgnGazeboMemoryRunner.hh"
 #endif // _IGN_GAZEBO
@@ -12,7 +16,19 @@
 
 struct MemoryRunnerFactory
 {
-  // simpleECM ignGazeboECM
+  /// \brief Get all of the MemoryRunner types that can be created
+  /// \return The types, which can be passed to Create
+  static std::vector<std::string> Types()
+  {
+    std::vector<std::string> types{"simpleECM"};
+#ifdef _ENTT
+    types.push_back("enttECM");
+#endif // _ENTT
+#ifdef _IGN_GAZEBO
+    types.push_back("ignGazeboECM");
+#endif // _IGN_GAZEBO
+    return types;
+  }
 
   /// \brief Create a MemoryRunner of a specific type
   /// \param[in] _type The type of MemoryRunner to create
@@ -22,6 +38,10 @@ struct MemoryRunnerFactory
   {
     if (_type == "simpleECM")
       return new SimpleECMMemoryRunner();
+#ifdef _ENTT
+    else if (_type == "enttECM")
+      return new EnttMemoryRunner();
+#endif // _ENTT
 #ifdef _IGN_GAZEBO
     else if (_type == "ignGazeboECM")
       return new IgnGazeboMemoryRunner();
@@ -0,0 +1,75 @@
+#ifndef PROCESS_MEMORY_HH_
+#define PROCESS_MEMORY_HH_
+
+#include <cstddef>
+#include <fstream>
+#ifdef __GLIBC__
+  #include <malloc.h>
+#endif // __GLIBC__
+#include <sstream>
+#include <string>
+
+/// \brief Read a memory field (in kB) from a file in /proc
+/// \param[in] _file The file (for example, "/proc/self/status")
+/// \param[in] _field The field to read (for example, "VmHWM")
+/// \return The value of the field in bytes, or 0 if the field couldn't be read
+/// (/proc is only available on Linux)
+std::size_t ProcFileBytes(const std::string &_file, const std::string &_field)
+{
+  std::ifstream file(_file);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.rfind(_field + ":", 0) != 0)
+      continue;
+
+    std::istringstream fieldStream(line.substr(_field.size() + 1));
+    std::size_t kiloBytes = 0;
+    fieldStream >> kiloBytes;
+    return kiloBytes * 1024;
+  }
+  return 0;
+}
+
+/// \brief Read a memory field (in kB) from /proc/self/status
+/// \param[in] _field The field to read (for example, "VmHWM")
+/// \return The value of the field in bytes, or 0 if the field couldn't be read
+std::size_t ProcessStatusBytes(const std::string &_field)
+{
+  return ProcFileBytes("/proc/self/status", _field);
+}
+
+/// \brief Get the peak resident set size of this process
+/// \return The peak RSS in bytes, or 0 if it isn't available
+std::size_t PeakRssBytes()
+{
+  return ProcessStatusBytes("VmHWM");
+}
+
+/// \brief Get the current resident set size of this process
+/// \return The current RSS in bytes, or 0 if it isn't available
+std::size_t CurrentRssBytes()
+{
+  return ProcessStatusBytes("VmRSS");
+}
+
+/// \brief Get the amount of this process's anonymous memory that is backed
+/// by transparent huge pages, which tells whether the kernel actually gave
+/// out the huge pages that were asked for
+/// \return The number of bytes, or 0 if it isn't available
+std::size_t AnonHugePageBytes()
+{
+  return ProcFileBytes("/proc/self/smaps_rollup", "AnonHugePages");
+}
+
+/// \brief Return memory that has been freed to the operating system, where
+/// the allocator supports it (glibc). Otherwise, memory that was freed stays
+/// part of the RSS and hides the growth of whatever is allocated next
+void ReleaseFreedMemory()
+{
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif // __GLIBC__
+}
+
+#endif
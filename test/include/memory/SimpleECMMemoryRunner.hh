@@ -1,11 +1,17 @@
 #ifndef SIMPLE_ECM_MEMORY_RUNNER_HH_
 #define SIMPLE_ECM_MEMORY_RUNNER_HH_
 
+#include <cstddef>
 #include <functional>
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "simpleECM/Components.hh"
 #include "simpleECM/Ecm.hh"
 #include "memory/MemoryRunner.hh"
+#include "memory/ViewPermutations.hh"
 
 class SimpleECMMemoryRunner : public MemoryRunner
 {
@@ -15,8 +21,50 @@ class SimpleECMMemoryRunner : public MemoryRunner
   /// \brief Documentation inherited
   public: void Run() final;
 
+  /// \brief Documentation inherited
+  public: void PrintStats(std::ostream &_os) const final;
+
+  /// \brief Documentation inherited
+  public: bool RegisterViews(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void RemoveAComponent(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: void AddAComponent(const std::size_t _count) final;
+
+  /// \brief Documentation inherited
+  public: std::size_t ViewBytes() const final;
+
+  /// \brief Documentation inherited
+  public: bool SetHugePages(const bool _hugePages) final;
+
+  /// \brief Documentation inherited
+  public: std::size_t HugePageBytes() const final;
+
+  /// \brief Register the view of some of the components
+  /// \tparam Indices The component numbers (see kNumViewComponents)
+  private: template<std::size_t ...Indices>
+           void RegisterView(std::index_sequence<Indices...>);
+
+  /// \brief The component types, in the order of their numbers (see
+  /// kNumViewComponents)
+  private: using ComponentTypes = std::tuple<Name,
+                                             Static,
+                                             LinearVelocity,
+                                             WorldLinearVelocity,
+                                             AngularVelocity,
+                                             WorldAngularVelocity,
+                                             LinearAcceleration,
+                                             WorldLinearAcceleration,
+                                             Pose,
+                                             WorldPose>;
+
   /// \brief The ECM that is being tested for memory usage
   private: ECM simpleEcm;
+
+  /// \brief The entities that were created with MakeEntityWithComponents
+  private: std::vector<Entity> entities;
 };
 
 void SimpleECMMemoryRunner::MakeEntityWithComponents()
@@ -32,6 +80,7 @@ void SimpleECMMemoryRunner::MakeEntityWithComponents()
   this->simpleEcm.AddComponent(entity, WorldLinearAcceleration());
   this->simpleEcm.AddComponent(entity, Pose());
   this->simpleEcm.AddComponent(entity, WorldPose());
+  this->entities.push_back(entity);
 }
 
 void SimpleECMMemoryRunner::Run()
@@ -147,4 +196,70 @@ void SimpleECMMemoryRunner::Run()
   }
 }
 
+void SimpleECMMemoryRunner::PrintStats(std::ostream &_os) const
+{
+  _os << this->simpleEcm.MemoryStats();
+
+  _os << std::endl << "View usage:" << std::endl;
+  for (const auto &viewStats : this->simpleEcm.ViewStats())
+  {
+    _os << "  <" << viewStats.name << ">" << std::endl
+      << "    uses " << viewStats.useCount
+      << "  builds " << viewStats.buildCount
+      << "  evictions " << viewStats.evictionCount
+      << "  rows " << viewStats.rows
+      << "  bytes " << viewStats.bytes << std::endl;
+  }
+}
+
+bool SimpleECMMemoryRunner::RegisterViews(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    WithViewPermutation(i, [this](auto _components)
+        {
+          this->RegisterView(_components);
+        });
+  }
+  return true;
+}
+
+void SimpleECMMemoryRunner::RemoveAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+    this->simpleEcm.RemoveComponent<LinearVelocity>(this->entities[i]);
+}
+
+void SimpleECMMemoryRunner::AddAComponent(const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+    this->simpleEcm.AddComponent(this->entities[i], LinearVelocity());
+}
+
+std::size_t SimpleECMMemoryRunner::ViewBytes() const
+{
+  const auto stats = this->simpleEcm.MemoryStats();
+  auto bytes = stats.viewIndexBytes;
+  for (const auto &view : stats.views)
+    bytes += view.TotalBytes();
+  return bytes;
+}
+
+bool SimpleECMMemoryRunner::SetHugePages(const bool _hugePages)
+{
+  return this->simpleEcm.SetHugePages(_hugePages);
+}
+
+std::size_t SimpleECMMemoryRunner::HugePageBytes() const
+{
+  return this->simpleEcm.MemoryStats().HugePageBytes();
+}
+
+template<std::size_t ...Indices>
+void SimpleECMMemoryRunner::RegisterView(std::index_sequence<Indices...>)
+{
+  this->simpleEcm.RegisterView<
+    std::tuple_element_t<Indices, ComponentTypes>...>();
+}
+
 #endif
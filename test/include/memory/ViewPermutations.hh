@@ -0,0 +1,124 @@
+#ifndef VIEW_PERMUTATIONS_HH_
+#define VIEW_PERMUTATIONS_HH_
+
+#include <cstddef>
+#include <utility>
+
+/// \brief The number of component types that views are made of. Component
+/// types are numbered in the order that the memory runners attach them to
+/// entities: Name, Static, LinearVelocity, WorldLinearVelocity,
+/// AngularVelocity, WorldAngularVelocity, LinearAcceleration,
+/// WorldLinearAcceleration, Pose, WorldPose
+constexpr std::size_t kNumViewComponents{10};
+
+/// \brief The number of distinct views that WithViewPermutation can describe.
+/// Every view is a separate template instantiation in every memory runner,
+/// so this is kept small enough for the memory benchmarks to compile in a
+/// reasonable time
+constexpr std::size_t kMaxViewPermutations{150};
+
+/// \brief The components of a view, in order
+struct ViewPermutation
+{
+  /// \brief The number of components
+  std::size_t size{0};
+
+  /// \brief The component numbers. Only the first size numbers are used
+  std::size_t components[3]{0, 0, 0};
+};
+
+/// \brief Get the components of a view. Views are numbered so that every
+/// view is distinct: the single components come first, then every ordered
+/// pair of components, and then ordered triples (a view of the same
+/// components in a different order is a different view, as in
+/// SimpleECMMemoryRunner::Run)
+/// \param[in] _view The number of the view
+/// \return The view's components
+constexpr ViewPermutation NthViewPermutation(std::size_t _view)
+{
+  ViewPermutation permutation;
+  if (_view < kNumViewComponents)
+  {
+    permutation.size = 1;
+    permutation.components[0] = _view;
+    return permutation;
+  }
+
+  _view -= kNumViewComponents;
+  const auto numPairs = kNumViewComponents * (kNumViewComponents - 1);
+  permutation.size = _view < numPairs ? 2 : 3;
+  if (permutation.size == 3)
+    _view -= numPairs;
+
+  // the view number is a mixed radix number, whose digit i picks one of the
+  // components that the first i digits didn't pick
+  for (std::size_t i = 0; i < permutation.size; ++i)
+  {
+    std::size_t divisor = 1;
+    for (auto j = i + 1; j < permutation.size; ++j)
+      divisor *= kNumViewComponents - j;
+    auto choice = _view / divisor;
+    _view %= divisor;
+
+    std::size_t component = 0;
+    for (;; ++component)
+    {
+      bool picked = false;
+      for (std::size_t j = 0; j < i; ++j)
+        picked = picked || permutation.components[j] == component;
+      if (picked)
+        continue;
+      if (choice == 0)
+        break;
+      --choice;
+    }
+    permutation.components[i] = component;
+  }
+  return permutation;
+}
+
+/// \brief Implementation of WithViewPermutation for a single view
+/// \param[in] _f The function
+template<std::size_t View, typename FunctionT, std::size_t ...Indices>
+void CallWithViewComponents(FunctionT &_f, std::index_sequence<Indices...>)
+{
+  constexpr auto permutation = NthViewPermutation(View);
+  _f(std::index_sequence<permutation.components[Indices]...>());
+}
+
+/// \brief Implementation of WithViewPermutation for a single view
+/// \param[in] _f The function
+template<std::size_t View, typename FunctionT>
+void CallWithViewPermutation(FunctionT &_f)
+{
+  CallWithViewComponents<View>(_f,
+      std::make_index_sequence<NthViewPermutation(View).size>());
+}
+
+/// \brief Implementation of WithViewPermutation
+/// \param[in] _view The number of the view
+/// \param[in] _f The function
+template<typename FunctionT, std::size_t ...Views>
+void WithViewPermutationImpl(const std::size_t _view, FunctionT &_f,
+    std::index_sequence<Views...>)
+{
+  using Call = void (*)(FunctionT &);
+  static constexpr Call calls[] = {
+    &CallWithViewPermutation<Views, FunctionT>...};
+  calls[_view](_f);
+}
+
+/// \brief Call a function with the components of a view (see
+/// NthViewPermutation)
+/// \param[in] _view The number of the view, which is less than
+/// kMaxViewPermutations
+/// \param[in] _f The function, which takes a std::index_sequence of the
+/// view's component numbers
+template<typename FunctionT>
+void WithViewPermutation(const std::size_t _view, FunctionT &&_f)
+{
+  WithViewPermutationImpl(_view, _f,
+      std::make_index_sequence<kMaxViewPermutations>());
+}
+
+#endif
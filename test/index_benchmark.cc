@@ -0,0 +1,212 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Static and a LinearVelocity. 1 in 100 entities "
+    << "is not static, and" << std::endl << "velocities are spread over 0-99. "
+    << "Filters on those fields are done in an Each(...)" << std::endl
+    << "callback and with secondary indexes." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage();
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief Time a query over the repetitions of the benchmark, checking the
+/// number of entities it visits
+/// \param[in] _options The benchmark options
+/// \param[in] _query Runs the query and returns the number of entities it
+/// visited
+/// \param[in] _expected The number of entities the query should visit
+/// \param[in,out] _valid Set to false if the query visited the wrong number
+/// of entities
+/// \return The samples, in milliseconds
+std::vector<double> TimeQuery(const BenchmarkOptions &_options,
+    const std::function<int()> &_query, const int _expected, bool &_valid)
+{
+  std::vector<double> samples;
+  for (auto i = -_options.warmup; i < _options.reps; ++i)
+  {
+    int count = 0;
+    const auto ms = TimeMs([&_query, &count]()
+        {
+          count = _query();
+        });
+    _valid = _valid && count == _expected;
+    if (i >= 0)
+      samples.push_back(ms);
+  }
+  return samples;
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM has secondary
+  //    indexes
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {}) || options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities"
+    << std::endl << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  ECM ecm;
+  int numDynamic = 0;
+  int numSlow = 0;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    const auto entity = ecm.CreateEntity();
+    Static staticComp;
+    staticComp.isStatic = i % 100 != 0;
+    ecm.AddComponent(entity, staticComp);
+    LinearVelocity linVel;
+    linVel.data.x = i % 100;
+    ecm.AddComponent(entity, linVel);
+    numDynamic += staticComp.isStatic ? 0 : 1;
+    numSlow += linVel.data.x < 10 ? 1 : 0;
+  }
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+  using Callback =
+    std::function<bool(const Entity &, Static *, LinearVelocity *)>;
+
+  // baselines: the filters are checked in the callback
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Each(...), filter !isStatic in callback", TimeQuery(options,
+          [&ecm]()
+          {
+            int count = 0;
+            ecm.Each<Static, LinearVelocity>(Callback(
+                [&count](const Entity &, Static *_static, LinearVelocity *)
+                {
+                  count += _static->isStatic ? 0 : 1;
+                  return true;
+                }));
+            return count;
+          }, numDynamic, valid)));
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Each(...), filter velocity in [0, 9] in callback", TimeQuery(options,
+          [&ecm]()
+          {
+            int count = 0;
+            ecm.Each<Static, LinearVelocity>(Callback(
+                [&count](const Entity &, Static *, LinearVelocity *_linVel)
+                {
+                  count += _linVel->data.x < 10 ? 1 : 0;
+                  return true;
+                }));
+            return count;
+          }, numSlow, valid)));
+
+  IndexHandle<HashIndex<Static, bool>> isStatic;
+  IndexHandle<OrderedIndex<LinearVelocity, int>> speed;
+  std::vector<double> createSamples;
+  createSamples.push_back(TimeMs([&ecm, &isStatic, &speed]()
+      {
+        isStatic = ecm.CreateIndex<HashIndex<Static, bool>>(
+            [](const Static &_static)
+            {
+              return _static.isStatic;
+            });
+        speed = ecm.CreateIndex<OrderedIndex<LinearVelocity, int>>(
+            [](const LinearVelocity &_linVel)
+            {
+              return _linVel.data.x;
+            });
+      }));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "CreateIndex(...) x2", createSamples));
+
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "EachWhere(...), hash index on isStatic", TimeQuery(options,
+          [&ecm, &isStatic]()
+          {
+            int count = 0;
+            ecm.EachWhere<Static, LinearVelocity>(isStatic, false, Callback(
+                [&count](const Entity &, Static *, LinearVelocity *)
+                {
+                  count++;
+                  return true;
+                }));
+            return count;
+          }, numDynamic, valid)));
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "EachInRange(...), ordered index on velocity", TimeQuery(options,
+          [&ecm, &speed]()
+          {
+            int count = 0;
+            ecm.EachInRange<Static, LinearVelocity>(speed, 0, 9, Callback(
+                [&count](const Entity &, Static *, LinearVelocity *)
+                {
+                  count++;
+                  return true;
+                }));
+            return count;
+          }, numSlow, valid)));
+
+  // 1% of the velocities change each repetition, and the changes are
+  // reported to the indexes
+  std::vector<double> modifySamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    const auto ms = TimeMs([&ecm, i]()
+        {
+          ecm.Each<LinearVelocity>(
+              std::function<bool(const Entity &, LinearVelocity *)>(
+                [&ecm, i](const Entity &_entity, LinearVelocity *_linVel)
+                {
+                  if (static_cast<int>(_entity % 100) != (i + 100) % 100)
+                    return true;
+                  _linVel->data.x = (_linVel->data.x + 1) % 100;
+                  ecm.MarkModified<LinearVelocity>(_entity);
+                  return true;
+                }));
+        });
+    if (i >= 0)
+      modifySamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Each(...) changing 1% of the velocities, with MarkModified",
+        modifySamples));
+
+  options.WriteResults(report);
+
+  if (!valid)
+    std::cerr << std::endl << "A query visited the wrong entities" << std::endl;
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Measures Each(...) (and EachChunk(...)) over <Pose, LinearVelocity, "
+    << "AngularVelocity>" << std::endl << "on a fresh ECM, "
+    << "after randomly removing and re-adding components, and after "
+    << "ECM::Compact()." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --churn-rounds <n>     rounds of random remove/add (default 10)"
+    << std::endl
+    << "  --churn-fraction <f>   fraction of entities changed per round "
+    << "(default 0.2)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief Time Each(...) calls on an ECM
+/// \param[in] _ecm The ECM
+/// \param[in] _options The benchmark options (warmup, repetitions)
+/// \param[in] _numEntities The number of entities that should be visited
+/// \param[out] _valid Set to false if the wrong number of entities were
+/// visited
+/// \param[out] _samples The time of each repetition is appended to this
+void TimeEach(ECM &_ecm, const BenchmarkOptions &_options,
+    const int _numEntities, bool &_valid, std::vector<double> &_samples)
+{
+  int count = 0;
+  const std::function<bool(const Entity &, Pose *, LinearVelocity *,
+      AngularVelocity *)> integrate =
+    [&count](const Entity &, Pose *_pose, LinearVelocity *_linVel,
+        AngularVelocity *_angVel)
+    {
+      _pose->position.x += _linVel->data.x;
+      _pose->position.y += _linVel->data.y;
+      _pose->position.z += _linVel->data.z;
+      _pose->orientation.x += _angVel->data.x;
+      count++;
+      return true;
+    };
+
+  for (auto i = -_options.warmup; i < _options.reps; ++i)
+  {
+    count = 0;
+    const auto ms = TimeMs([&_ecm, &integrate]()
+        {
+          _ecm.Each<Pose, LinearVelocity, AngularVelocity>(integrate);
+        });
+    _valid = _valid && count == _numEntities;
+    if (i >= 0)
+      _samples.push_back(ms);
+  }
+}
+
+/// \brief Time EachChunk(...) calls on an ECM, which do the same work as the
+/// Each(...) calls of TimeEach
+/// \param[in] _ecm The ECM
+/// \param[in] _options The benchmark options (warmup, repetitions)
+/// \param[in] _numEntities The number of entities that should be visited
+/// \param[out] _valid Set to false if the wrong number of entities were
+/// visited
+/// \param[out] _samples The time of each repetition is appended to this
+void TimeEachChunk(ECM &_ecm, const BenchmarkOptions &_options,
+    const int _numEntities, bool &_valid, std::vector<double> &_samples)
+{
+  std::size_t count = 0;
+  const std::function<bool(Span<const Entity>, Span<Pose>,
+      Span<LinearVelocity>, Span<AngularVelocity>)> integrate =
+    [&count](Span<const Entity> _entities, Span<Pose> _poses,
+        Span<LinearVelocity> _linVels, Span<AngularVelocity> _angVels)
+    {
+      for (std::size_t i = 0; i < _entities.size(); ++i)
+      {
+        _poses[i].position.x += _linVels[i].data.x;
+        _poses[i].position.y += _linVels[i].data.y;
+        _poses[i].position.z += _linVels[i].data.z;
+        _poses[i].orientation.x += _angVels[i].data.x;
+      }
+      count += _entities.size();
+      return true;
+    };
+
+  for (auto i = -_options.warmup; i < _options.reps; ++i)
+  {
+    count = 0;
+    const auto ms = TimeMs([&_ecm, &integrate]()
+        {
+          _ecm.EachChunk<Pose, LinearVelocity, AngularVelocity>(integrate);
+        });
+    _valid = _valid && count == static_cast<std::size_t>(_numEntities);
+    if (i >= 0)
+      _samples.push_back(ms);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner is
+  //    ignored, since only the simple ECM supports compaction
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--churn-rounds", "--churn-fraction"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto churnRounds = std::stoi(options.Extra("--churn-rounds", "10"));
+  const auto churnFraction =
+    std::stod(options.Extra("--churn-fraction", "0.2"));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities, "
+    << churnRounds << " round(s) of churn changing " << churnFraction * 100
+    << "% of the entities" << std::endl << options.instances
+    << " instance(s), " << options.warmup << " warmup call(s), "
+    << options.reps << " repetition(s)" << std::endl << std::endl;
+
+  bool valid = true;
+  std::vector<double> freshSamples;
+  std::vector<double> churnSamples;
+  std::vector<double> churnedEachSamples;
+  std::vector<double> compactSamples;
+  std::vector<double> compactedEachSamples;
+  std::vector<double> churnedChunkSamples;
+  std::vector<double> compactedChunkSamples;
+  std::mt19937 rng(1234);
+  for (auto instance = 0; instance < options.instances; ++instance)
+  {
+    ECM ecm;
+    std::vector<Entity> entities;
+    for (auto i = 0; i < numEntities; ++i)
+    {
+      const auto entity = ecm.CreateEntity();
+      ecm.AddComponent(entity, Name());
+      ecm.AddComponent(entity, Pose());
+      ecm.AddComponent(entity, LinearVelocity());
+      ecm.AddComponent(entity, AngularVelocity());
+      entities.push_back(entity);
+    }
+    TimeEach(ecm, options, numEntities, valid, freshSamples);
+
+    // remove components from random entities and add them back in a different
+    // random order, which scatters both the view rows and component storage
+    churnSamples.push_back(TimeMs([&]()
+        {
+          const auto numChanged =
+            static_cast<std::size_t>(numEntities * churnFraction);
+          for (auto round = 0; round < churnRounds; ++round)
+          {
+            std::shuffle(entities.begin(), entities.end(), rng);
+            std::vector<Entity> changed(entities.begin(),
+                entities.begin() + numChanged);
+            for (const auto &entity : changed)
+            {
+              ecm.RemoveComponent<Pose>(entity);
+              ecm.RemoveComponent<LinearVelocity>(entity);
+            }
+            std::shuffle(changed.begin(), changed.end(), rng);
+            for (const auto &entity : changed)
+              ecm.AddComponent(entity, LinearVelocity());
+            std::shuffle(changed.begin(), changed.end(), rng);
+            for (const auto &entity : changed)
+              ecm.AddComponent(entity, Pose());
+          }
+        }));
+    if (instance == 0)
+    {
+      std::cout << "Layout churn after the random changes: "
+        << ecm.LayoutChurn() << std::endl << std::endl;
+    }
+    TimeEach(ecm, options, numEntities, valid, churnedEachSamples);
+    TimeEachChunk(ecm, options, numEntities, valid, churnedChunkSamples);
+
+    compactSamples.push_back(TimeMs([&ecm, &valid]()
+        {
+          valid = ecm.Compact() && valid;
+        }));
+    TimeEach(ecm, options, numEntities, valid, compactedEachSamples);
+    TimeEachChunk(ecm, options, numEntities, valid, compactedChunkSamples);
+  }
+
+  const std::string runner = "simpleECM";
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each(...) fresh", freshSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Random remove/add", churnSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each(...) after churn", churnedEachSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "EachChunk(...) after churn", churnedChunkSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Compact()", compactSamples));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each(...) after Compact()", compactedEachSamples));
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "EachChunk(...) after Compact()", compactedChunkSamples));
+
+  options.WriteResults(report);
+
+  if (!valid)
+    std::cerr << std::endl << "Each visited the wrong entities" << std::endl;
+  return valid ? 0 : 1;
+}
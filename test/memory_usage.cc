@@ -1,31 +1,53 @@
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "memory/MemoryRunner.hh"
 #include "memory/MemoryRunnerFactory.hh"
+#include "memory/ProcessMemory.hh"
 
 int main(int argc, char **argv)
 {
   // command line arguments are as follows:
-  //  * the implementation to be memory tested (required). Must be one of:
+  //  * the implementation to be memory tested (required). Must be one of the
+  //    types in MemoryRunnerFactory::Types():
   //    - simpleECM
+  //    - enttECM
   //    - ignGazeboECM
   //  * the number of entities to generate (optional). This should be a
   //    non-negative integer (default is 1000)
+  //  * --huge-pages (optional, anywhere), which makes the ECM use huge pages
+  //    for its storage
+  std::vector<std::string> args;
+  bool hugePages = false;
+  for (auto i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--huge-pages")
+      hugePages = true;
+    else
+      args.push_back(argv[i]);
+  }
+
   std::string ecmImpl;
   int numEntities = 1000;
-  if (argc >= 2)
+  if (!args.empty() && args.size() <= 2)
   {
-    ecmImpl = argv[1];
-    if (argc == 3)
-      numEntities = std::stoi(argv[2]);
+    ecmImpl = args[0];
+    if (args.size() == 2)
+      numEntities = std::stoi(args[1]);
   }
   else
   {
+    std::string implementations;
+    for (const auto &type : MemoryRunnerFactory::Types())
+      implementations += (implementations.empty() ? "" : ", ") + type;
     std::cerr << "Usage: " << argv[0]
-      << " <ECM implementation> [number of Entities]" << std::endl << std::endl
-      << "<ECM implementation> should either be simpleECM or ignGazeboECM"
-      << std::endl;
+      << " <ECM implementation> [number of Entities] [--huge-pages]"
+      << std::endl << std::endl
+      << "<ECM implementation> should be one of: " << implementations
+      << std::endl
+      << "--huge-pages makes the ECM allocate its storage from memory that "
+      << "is backed by" << std::endl << "transparent huge pages" << std::endl;
     return -1;
   }
 
@@ -33,11 +55,42 @@ int main(int argc, char **argv)
   auto memoryRunner = MemoryRunnerFactory::Create(ecmImpl);
   if (!memoryRunner)
     return -1;
+  if (hugePages && !memoryRunner->SetHugePages(true))
+  {
+    std::cerr << ecmImpl << " can't use huge pages on this platform"
+      << std::endl;
+    delete memoryRunner;
+    return -1;
+  }
   std::cout << ecmImpl << " memory test for " << numEntities << " entities"
-    << std::endl;
+    << (hugePages ? ", using huge pages" : "") << std::endl;
+  const auto startRss = CurrentRssBytes();
   for (auto i = 0; i < numEntities; ++i)
     memoryRunner->MakeEntityWithComponents();
+  const auto createdRss = CurrentRssBytes();
   memoryRunner->Run();
+  const auto runRss = CurrentRssBytes();
+
+  std::cout << std::endl;
+  memoryRunner->PrintStats(std::cout);
+  std::cout << std::endl
+    << "RSS before creating entities: " << startRss << " bytes" << std::endl
+    << "RSS after creating entities:  " << createdRss << " bytes" << std::endl
+    << "RSS after Run():              " << runRss << " bytes" << std::endl
+    << "Peak RSS:                     " << PeakRssBytes() << " bytes"
+    << std::endl;
+
+  // the kernel can back huge page mappings with regular pages (if huge pages
+  // are turned off or fragmented), so what it actually gave out is reported
+  // too
+  if (hugePages)
+  {
+    std::cout << "Huge page mappings:           "
+      << memoryRunner->HugePageBytes() << " bytes" << std::endl
+      << "Backed by huge pages:         " << AnonHugePageBytes() << " bytes"
+      << std::endl;
+  }
+
   delete memoryRunner;
   memoryRunner = nullptr;
 
@@ -0,0 +1,183 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+#include "simpleECM/InternedString.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a unique Name and a Pose. Random names are looked up "
+    << "with an" << std::endl << "Each<Name>(...) scan and with "
+    << "EntityByName(...)." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --lookups <n>          the number of lookups per repetition "
+    << "(default 100)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM has a name index
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--lookups"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto numLookups = std::stoi(options.Extra("--lookups", "100"));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("lookups", std::to_string(numLookups));
+  report.SetParameter("nameComponentBytes", std::to_string(sizeof(Name)));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " named entities, "
+    << numLookups << " lookups per repetition" << std::endl
+    << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  ECM ecm;
+  std::vector<Entity> entities;
+  std::vector<double> createSamples;
+  createSamples.push_back(TimeMs([&ecm, &entities, numEntities]()
+      {
+        for (auto i = 0; i < numEntities; ++i)
+        {
+          const auto entity = ecm.CreateEntity();
+          Name name;
+          name.name = "entity_" + std::to_string(i);
+          ecm.AddComponent(entity, name);
+          ecm.AddComponent(entity, Pose());
+          entities.push_back(entity);
+        }
+      }));
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> index(0, numEntities - 1);
+  std::vector<int> lookups;
+  std::vector<std::string> names;
+  for (auto i = 0; i < numLookups; ++i)
+  {
+    lookups.push_back(index(rng));
+    names.push_back("entity_" + std::to_string(lookups.back()));
+  }
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Create named entities", createSamples));
+
+  // baseline: every lookup goes through all of the names
+  std::vector<double> scanSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    std::vector<Entity> found;
+    const auto ms = TimeMs([&ecm, &names, &found]()
+        {
+          for (const auto &name : names)
+          {
+            auto result = kNullEntity;
+            ecm.Each<Name>(std::function<bool(const Entity &, Name *)>(
+                  [&name, &result](const Entity &_entity, Name *_name)
+                  {
+                    if (_name->name.Str() != name)
+                      return true;
+                    result = _entity;
+                    return false;
+                  }));
+            found.push_back(result);
+          }
+        });
+    for (std::size_t l = 0; l < found.size(); ++l)
+      valid = valid && found[l] == entities[lookups[l]];
+    if (i >= 0)
+      scanSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Each<Name>(...) scan, " + std::to_string(numLookups) + " lookups",
+        scanSamples));
+
+  std::vector<double> indexSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    std::vector<Entity> found;
+    const auto ms = TimeMs([&ecm, &names, &found]()
+        {
+          for (const auto &name : names)
+            found.push_back(ecm.EntityByName(name));
+        });
+    for (std::size_t l = 0; l < found.size(); ++l)
+      valid = valid && found[l] == entities[lookups[l]];
+    if (i >= 0)
+      indexSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "EntityByName(...), " + std::to_string(numLookups) + " lookups",
+        indexSamples));
+
+  // renaming has to keep the index up to date
+  std::vector<double> renameSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    const auto ms = TimeMs([&ecm, &entities, &lookups, i]()
+        {
+          for (const auto l : lookups)
+          {
+            ecm.SetName(entities[l], "renamed_" + std::to_string(i) + "_" +
+                std::to_string(l));
+          }
+        });
+    if (i >= 0)
+      renameSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "SetName(...), " + std::to_string(numLookups) + " entities",
+        renameSamples));
+
+  const auto stats = ecm.MemoryStats();
+  for (const auto &component : stats.components)
+  {
+    if (component.typeId == Name::typeId)
+      std::cout << std::endl << "Name storage: " << component.TotalBytes()
+        << " bytes (" << sizeof(Name) << " bytes per component)";
+  }
+  for (const auto &index : stats.indexes)
+    std::cout << std::endl << index.name << ": " << index.bytes << " bytes";
+  std::cout << std::endl << "Interned strings: "
+    << InternedString::TableSize() << " (" << InternedString::TableBytes()
+    << " bytes)" << std::endl;
+
+  options.WriteResults(report);
+
+  if (!valid)
+    std::cerr << std::endl << "A lookup found the wrong entity" << std::endl;
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Name and a Pose, and a fraction of them (1%, 10% "
+    << "and 100%)" << std::endl << "also have a LinearVelocity. "
+    << "Queries are for <Pose, LinearVelocity>." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage();
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM supports transient
+  //    queries
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv) || options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  bool valid = true;
+  for (const auto percentMatching : {1, 10, 100})
+  {
+    // every (100 / percentMatching)th entity matches the query
+    const auto stride = 100 / percentMatching;
+    ECM ecm;
+    int numMatching = 0;
+    for (auto i = 0; i < numEntities; ++i)
+    {
+      const auto entity = ecm.CreateEntity();
+      ecm.AddComponent(entity, Name());
+      ecm.AddComponent(entity, Pose());
+      if (i % stride == 0)
+      {
+        ecm.AddComponent(entity, LinearVelocity());
+        numMatching++;
+      }
+    }
+
+    const auto percentStr = std::to_string(percentMatching) + "% match";
+    std::cout << std::endl << "-----" << std::endl << std::endl
+      << numEntities << " entities, " << numMatching << " (" << percentStr
+      << ") with <Pose, LinearVelocity>" << std::endl << std::endl;
+
+    int count = 0;
+    const std::function<bool(const Entity &, Pose *, LinearVelocity *)> countF =
+      [&count](const Entity &, Pose *, LinearVelocity *)
+      {
+        count++;
+        return true;
+      };
+
+    // a transient query never creates a view
+    std::vector<double> transientSamples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      count = 0;
+      const auto ms = TimeMs([&ecm, &countF]()
+          {
+            ecm.EachTransient<Pose, LinearVelocity>(countF);
+          });
+      valid = valid && count == numMatching && ecm.ViewCount() == 0;
+      if (i >= 0)
+        transientSamples.push_back(ms);
+    }
+
+    // a one-off Each builds (and caches) a view, which is destroyed
+    // afterwards so that the next Each has to build it again
+    std::vector<double> buildSamples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      count = 0;
+      const auto ms = TimeMs([&ecm, &countF]()
+          {
+            ecm.Each<Pose, LinearVelocity>(countF);
+          });
+      valid = valid && count == numMatching;
+      ecm.DestroyView<Pose, LinearVelocity>();
+      if (i >= 0)
+        buildSamples.push_back(ms);
+    }
+
+    // repeated Each calls use the cached view
+    std::vector<double> cachedSamples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      count = 0;
+      const auto ms = TimeMs([&ecm, &countF]()
+          {
+            ecm.Each<Pose, LinearVelocity>(countF);
+          });
+      valid = valid && count == numMatching;
+      if (i >= 0)
+        cachedSamples.push_back(ms);
+    }
+
+    BenchmarkReport::Print(std::cout, report.Add(percentStr,
+          "EachTransient(...)", transientSamples));
+    BenchmarkReport::Print(std::cout, report.Add(percentStr,
+          "Each(...) building the view", buildSamples));
+    BenchmarkReport::Print(std::cout, report.Add(percentStr,
+          "Each(...) with a cached view", cachedSamples));
+  }
+
+  options.WriteResults(report);
+
+  if (!valid)
+    std::cerr << std::endl << "A query visited the wrong entities" << std::endl;
+  return valid ? 0 : 1;
+}
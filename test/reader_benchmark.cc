@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Name, Pose and LinearVelocity. Reader threads run "
+    << "EachCommitted(...)" << std::endl << "over <Pose, LinearVelocity> "
+    << "concurrently, between writer phases that change 1% of" << std::endl
+    << "the entities and commit the changes." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --max-readers <n>      the most reader threads to run (default: the "
+    << "number of" << std::endl
+    << "                         hardware threads)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM supports reader
+  //    phases. --pin only pins the main (writer) thread
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--max-readers"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto hardwareThreads =
+    std::max(1u, std::thread::hardware_concurrency());
+  const auto maxReaders = std::stoi(
+      options.Extra("--max-readers", std::to_string(hardwareThreads)));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("hardwareThreads", std::to_string(hardwareThreads));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities, "
+    << "up to " << maxReaders << " reader thread(s)" << std::endl
+    << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  ECM ecm;
+  std::vector<Entity> entities;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    const auto entity = ecm.CreateEntity();
+    ecm.AddComponent(entity, Name());
+    ecm.AddComponent(entity, Pose());
+    ecm.AddComponent(entity, LinearVelocity());
+    entities.push_back(entity);
+  }
+
+  // the view is created and committed once, by the writer
+  ecm.Each<Pose, LinearVelocity>(
+      std::function<bool(const Entity &, Pose *, LinearVelocity *)>(
+        [](const Entity &, Pose *, LinearVelocity *)
+        {
+          return true;
+        }));
+
+  // a reader sums up the poses that the velocities lead to, so that it has
+  // to read every component
+  std::atomic<bool> valid{true};
+  const auto read = [&ecm, &valid, numEntities]()
+    {
+      const auto reads = ecm.BeginReads();
+      int count = 0;
+      long long sum = 0;
+      ecm.EachCommitted<Pose, LinearVelocity>(
+          std::function<bool(const Entity &, const Pose *,
+                             const LinearVelocity *)>(
+            [&count, &sum](const Entity &, const Pose *_pose,
+                const LinearVelocity *_linVel)
+            {
+              sum += _pose->position.x + _linVel->data.x;
+              count++;
+              return true;
+            }));
+      if (count != numEntities || sum < 0)
+        valid = false;
+    };
+
+  // the writer removes and re-adds the velocity of 1% of the entities, which
+  // leaves new entities in the view until the phase commits
+  std::size_t nextChanged = 0;
+  const auto write = [&ecm, &entities, &nextChanged]()
+    {
+      const auto phase = ecm.BeginWrites();
+      ecm.Each<Pose, LinearVelocity>(
+          std::function<bool(const Entity &, Pose *, LinearVelocity *)>(
+            [](const Entity &, Pose *_pose, LinearVelocity *_linVel)
+            {
+              _pose->position.x += _linVel->data.x;
+              return true;
+            }));
+      for (std::size_t i = 0; i < entities.size() / 100; ++i)
+      {
+        const auto entity = entities[nextChanged++ % entities.size()];
+        ecm.RemoveComponent<LinearVelocity>(entity);
+        ecm.AddComponent(entity, LinearVelocity());
+      }
+    };
+
+  std::vector<double> writeSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    const auto ms = TimeMs(write);
+    if (i >= 0)
+      writeSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add("simpleECM",
+        "Writer phase (Each, 1% remove/add, Commit)", writeSamples));
+
+  // every reader does one pass over the view, so with enough cores the time
+  // for all readers to finish should stay close to the time of one reader.
+  // Reader counts double up to (and including) the maximum
+  std::vector<int> readerCounts;
+  for (auto numReaders = 1; numReaders < maxReaders; numReaders *= 2)
+    readerCounts.push_back(numReaders);
+  readerCounts.push_back(maxReaders);
+  for (const auto numReaders : readerCounts)
+  {
+    std::vector<double> readSamples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      write();
+      const auto ms = TimeMs([&read, numReaders]()
+          {
+            std::vector<std::thread> readers;
+            for (auto r = 0; r < numReaders; ++r)
+              readers.emplace_back(read);
+            for (auto &reader : readers)
+              reader.join();
+          });
+      if (i >= 0)
+        readSamples.push_back(ms);
+    }
+
+    BenchmarkReport::Print(std::cout, report.Add("simpleECM",
+          "EachCommitted(...) on " + std::to_string(numReaders) +
+          " reader(s)", readSamples));
+  }
+
+  options.WriteResults(report);
+
+  if (!valid)
+  {
+    std::cerr << std::endl << "A reader visited the wrong entities"
+      << std::endl;
+  }
+  return valid ? 0 : 1;
+}
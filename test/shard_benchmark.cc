@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+#include "simpleECM/ShardedEcm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has the 10 components of the benchmark test. The "
+    << "entities are spread" << std::endl << "over the shards of a "
+    << "ShardedECM, and a batch of them is moved back and forth" << std::endl
+    << "between two shards." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --shards <n>           the number of shards (default 4)"
+    << std::endl
+    << "  --migrate <n>          the number of entities moved at once "
+    << "(default 10000)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief Create an entity with the 10 components of the benchmark test
+/// \param[in] _ecm The ECM
+/// \return The entity
+Entity MakeEntityWithComponents(ECM &_ecm)
+{
+  const auto entity = _ecm.CreateEntity();
+  _ecm.AddComponent(entity, Name());
+  _ecm.AddComponent(entity, Static());
+  _ecm.AddComponent(entity, LinearVelocity());
+  _ecm.AddComponent(entity, WorldLinearVelocity());
+  _ecm.AddComponent(entity, AngularVelocity());
+  _ecm.AddComponent(entity, WorldAngularVelocity());
+  _ecm.AddComponent(entity, LinearAcceleration());
+  _ecm.AddComponent(entity, WorldLinearAcceleration());
+  _ecm.AddComponent(entity, Pose());
+  _ecm.AddComponent(entity, WorldPose());
+  return entity;
+}
+
+/// \brief Move an entity to another ECM one component at a time, which is
+/// what migration costs without ECM::ExtractEntities. Components are default
+/// constructed in the destination (there is no public way to read a single
+/// component), so this is a lower bound
+/// \param[in] _entity The entity
+/// \param[in] _from The ECM the entity is in
+/// \param[in] _to The ECM to move the entity to
+/// \return The entity's ID in _to
+Entity MoveEntityPerComponent(const Entity &_entity, ECM &_from, ECM &_to)
+{
+  const auto moved = MakeEntityWithComponents(_to);
+  _from.RemoveComponent<Name>(_entity);
+  _from.RemoveComponent<Static>(_entity);
+  _from.RemoveComponent<LinearVelocity>(_entity);
+  _from.RemoveComponent<WorldLinearVelocity>(_entity);
+  _from.RemoveComponent<AngularVelocity>(_entity);
+  _from.RemoveComponent<WorldAngularVelocity>(_entity);
+  _from.RemoveComponent<LinearAcceleration>(_entity);
+  _from.RemoveComponent<WorldLinearAcceleration>(_entity);
+  _from.RemoveComponent<Pose>(_entity);
+  _from.RemoveComponent<WorldPose>(_entity);
+  return moved;
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM supports sharding
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--shards", "--migrate"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto numShards =
+    std::max(2, std::stoi(options.Extra("--shards", "4")));
+  const auto numMigrated = std::stoi(options.Extra("--migrate", "10000"));
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  std::cout << "Creating a ShardedECM with " << numEntities << " entities in "
+    << numShards << " shards, moving " << numMigrated << " entities at once"
+    << std::endl << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  std::atomic<int> count{0};
+  const std::function<bool(const Entity &, Name *, Static *, LinearVelocity *,
+      WorldLinearVelocity *, AngularVelocity *, WorldAngularVelocity *,
+      LinearAcceleration *, WorldLinearAcceleration *, Pose *, WorldPose *)>
+    findAllComponents = [&count](const Entity &, Name *, Static *,
+        LinearVelocity *, WorldLinearVelocity *, AngularVelocity *,
+        WorldAngularVelocity *, LinearAcceleration *,
+        WorldLinearAcceleration *, Pose *, WorldPose *)
+    {
+      count.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    };
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+
+  // baseline: all of the entities in a single ECM
+  {
+    ECM ecm;
+    for (auto i = 0; i < numEntities; ++i)
+      MakeEntityWithComponents(ecm);
+
+    std::vector<double> samples;
+    for (auto i = -options.warmup; i < options.reps; ++i)
+    {
+      count = 0;
+      const auto ms = TimeMs([&ecm, &findAllComponents]()
+          {
+            ecm.Each(findAllComponents);
+          });
+      valid = valid && count == numEntities;
+      if (i >= 0)
+        samples.push_back(ms);
+    }
+    BenchmarkReport::Print(std::cout,
+        report.Add(runner, "Each(...), 1 ECM", samples));
+  }
+
+  ShardedECM world(numShards);
+  std::vector<Entity> firstShardEntities;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    const auto shard = static_cast<std::size_t>(i % numShards);
+    const auto entity = MakeEntityWithComponents(world.Shard(shard));
+    if (shard == 0 &&
+        firstShardEntities.size() < static_cast<std::size_t>(numMigrated))
+      firstShardEntities.push_back(entity);
+  }
+
+  std::vector<double> eachSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    count = 0;
+    const auto ms = TimeMs([&world, &findAllComponents]()
+        {
+          world.Each(findAllComponents);
+        });
+    valid = valid && count == numEntities;
+    if (i >= 0)
+      eachSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "ShardedECM::Each(...), " + std::to_string(numShards) +
+        " shards in parallel", eachSamples));
+
+  // move the batch from shard 0 to shard 1 and back again, so that the
+  // shards stay the same size. The views of both shards are kept up to date
+  std::vector<double> migrateSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    const auto from = static_cast<std::size_t>((i + options.warmup) % 2);
+    std::size_t numMoved = 0;
+    const auto ms = TimeMs([&world, &firstShardEntities, &numMoved, from]()
+        {
+          numMoved = world.Migrate(firstShardEntities, from, 1 - from);
+        });
+    valid = valid && numMoved == firstShardEntities.size();
+    if (i >= 0)
+      migrateSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Migrate(...) of " + std::to_string(firstShardEntities.size()) +
+        " entities", migrateSamples));
+
+  // the same moves, one component at a time (after an odd number of moves,
+  // the batch is in shard 1)
+  std::vector<double> perComponentSamples;
+  std::vector<Entity> moving = firstShardEntities;
+  if ((options.warmup + options.reps) % 2)
+    world.Migrate(moving, 1, 0);
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    const auto from = static_cast<std::size_t>((i + options.warmup) % 2);
+    const auto ms = TimeMs([&world, &moving, from]()
+        {
+          for (auto &entity : moving)
+          {
+            entity = MoveEntityPerComponent(entity, world.Shard(from),
+                world.Shard(1 - from));
+          }
+        });
+    if (i >= 0)
+      perComponentSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "AddComponent/RemoveComponent of " + std::to_string(moving.size()) +
+        " entities", perComponentSamples));
+
+  options.WriteResults(report);
+
+  if (!valid)
+    std::cerr << std::endl << "Each visited the wrong entities" << std::endl;
+  return valid ? 0 : 1;
+}
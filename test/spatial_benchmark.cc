@@ -0,0 +1,198 @@
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Pose and a LinearVelocity, at a random position in "
+    << "a cube that holds" << std::endl << "about one entity per 10x10x10 "
+    << "block. Radius queries around random points are answered" << std::endl
+    << "with a full Each(...) scan and with EachInRadius(...) on a spatial "
+    << "index." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --queries <n>          the number of queries per repetition "
+    << "(default 1000)" << std::endl
+    << "  --radius <n>           the query radius (default 20)" << std::endl
+    << "  --cell <n>             the cell size of the spatial index (default: "
+    << "the radius)" << std::endl;
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM has spatial indexes
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--queries", "--radius", "--cell"}) ||
+      options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto numQueries = std::stoi(options.Extra("--queries", "1000"));
+  const auto radius = std::stoi(options.Extra("--radius", "20"));
+  const auto cellSize =
+    std::stoi(options.Extra("--cell", std::to_string(radius)));
+  options.Apply();
+
+  // the cube grows with the number of entities, so that the number of
+  // entities near a query point stays the same
+  const auto extent = static_cast<int>(std::cbrt(numEntities) * 10);
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("queries", std::to_string(numQueries));
+  report.SetParameter("radius", std::to_string(radius));
+  report.SetParameter("cellSize", std::to_string(cellSize));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities in a cube "
+    << "of size " << extent << ", " << numQueries << " queries of radius "
+    << radius << " per repetition, cell size " << cellSize << std::endl
+    << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> coordinate(0, extent);
+  ECM ecm;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    const auto entity = ecm.CreateEntity();
+    Pose pose;
+    pose.position = {coordinate(rng), coordinate(rng), coordinate(rng)};
+    ecm.AddComponent(entity, pose);
+    ecm.AddComponent(entity, LinearVelocity());
+  }
+  std::vector<Vector3i> centers;
+  for (auto i = 0; i < numQueries; ++i)
+    centers.push_back({coordinate(rng), coordinate(rng), coordinate(rng)});
+
+  bool valid = true;
+  const std::string runner = "simpleECM";
+  const auto radiusSquared = static_cast<std::int64_t>(radius) * radius;
+
+  // baseline: every query goes through all of the entities
+  std::int64_t scanFound = 0;
+  std::vector<double> scanSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    std::int64_t found = 0;
+    const auto ms = TimeMs([&ecm, &centers, &found, radiusSquared]()
+        {
+          for (const auto &center : centers)
+          {
+            ecm.Each<Pose, LinearVelocity>(
+                std::function<bool(const Entity &, Pose *, LinearVelocity *)>(
+                  [&found, &center, radiusSquared](const Entity &,
+                      Pose *_pose, LinearVelocity *)
+                  {
+                    const std::int64_t dx = _pose->position.x - center.x;
+                    const std::int64_t dy = _pose->position.y - center.y;
+                    const std::int64_t dz = _pose->position.z - center.z;
+                    if (dx * dx + dy * dy + dz * dz <= radiusSquared)
+                      found++;
+                    return true;
+                  }));
+          }
+        });
+    scanFound = found;
+    if (i >= 0)
+      scanSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "Each(...) scan, " + std::to_string(numQueries) + " queries",
+        scanSamples));
+
+  std::vector<double> createSamples;
+  createSamples.push_back(TimeMs([&ecm, cellSize]()
+      {
+        ecm.CreateSpatialIndex<Pose>(cellSize);
+      }));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "CreateSpatialIndex<Pose>()", createSamples));
+
+  std::vector<double> indexSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    std::int64_t found = 0;
+    const auto ms = TimeMs([&ecm, &centers, &found, radius]()
+        {
+          for (const auto &center : centers)
+          {
+            ecm.EachInRadius<Pose, LinearVelocity>(center, radius,
+                std::function<bool(const Entity &, Pose *, LinearVelocity *)>(
+                  [&found](const Entity &, Pose *, LinearVelocity *)
+                  {
+                    found++;
+                    return true;
+                  }));
+          }
+        });
+    valid = valid && found == scanFound;
+    if (i >= 0)
+      indexSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "EachInRadius(...), " + std::to_string(numQueries) + " queries",
+        indexSamples));
+
+  // every entity moves a little, and the index catches up
+  std::uniform_int_distribution<int> step(-2, 2);
+  std::vector<double> updateSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    ecm.Each<Pose>(std::function<bool(const Entity &, Pose *)>(
+          [&rng, &step](const Entity &, Pose *_pose)
+          {
+            _pose->position.x += step(rng);
+            _pose->position.y += step(rng);
+            _pose->position.z += step(rng);
+            return true;
+          }));
+    const auto ms = TimeMs([&ecm]()
+        {
+          ecm.UpdateSpatialIndex<Pose>();
+        });
+    if (i >= 0)
+      updateSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout, report.Add(runner,
+        "UpdateSpatialIndex<Pose>() after moving every entity",
+        updateSamples));
+
+  options.WriteResults(report);
+
+  if (!valid)
+  {
+    std::cerr << std::endl << "EachInRadius found the wrong entities"
+      << std::endl;
+  }
+  return valid ? 0 : 1;
+}
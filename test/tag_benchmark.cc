@@ -0,0 +1,163 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "simpleECM/Components.hh"
+#include "simpleECM/Ecm.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> [options]"
+    << std::endl << std::endl
+    << "Every entity has a Pose. Every entity is also marked with a World tag "
+    << "(which only" << std::endl << "stores membership) and with a Static "
+    << "component (which stores a flag per" << std::endl << "entity), and the "
+    << "two markers are compared." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage();
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief Get the memory used by the storage of a component type
+/// \param[in] _ecm The ECM
+/// \param[in] _typeId The component type
+/// \return The number of bytes
+std::size_t StorageBytes(const ECM &_ecm, const ComponentTypeId &_typeId)
+{
+  for (const auto &component : _ecm.MemoryStats().components)
+  {
+    if (component.typeId == _typeId)
+      return component.TotalBytes();
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * options (see PrintUsage), which may appear anywhere. --runner and
+  //    --instances are ignored, since only the simple ECM has tags
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {}) || options.positional.size() != 1)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  options.Apply();
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  options.AddParameters(report);
+
+  std::cout << "Creating an ECM with " << numEntities << " entities"
+    << std::endl << options.warmup << " warmup call(s), " << options.reps
+    << " repetition(s)" << std::endl << std::endl;
+
+  ECM ecm;
+  std::vector<Entity> entities;
+  for (auto i = 0; i < numEntities; ++i)
+  {
+    entities.push_back(ecm.CreateEntity());
+    ecm.AddComponent(entities.back(), Pose());
+  }
+
+  const std::string runner = "simpleECM";
+  std::vector<double> addTagSamples;
+  addTagSamples.push_back(TimeMs([&ecm, &entities]()
+      {
+        for (const auto &entity : entities)
+          ecm.AddComponent(entity, World());
+      }));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "AddComponent<World>() (tag)", addTagSamples));
+
+  std::vector<double> addFlagSamples;
+  addFlagSamples.push_back(TimeMs([&ecm, &entities]()
+      {
+        for (const auto &entity : entities)
+          ecm.AddComponent(entity, Static());
+      }));
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "AddComponent<Static>() (data)", addFlagSamples));
+
+  bool valid = true;
+  std::vector<double> eachTagSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    int count = 0;
+    const auto ms = TimeMs([&ecm, &count]()
+        {
+          ecm.Each<World, Pose>(
+              std::function<bool(const Entity &, World *, Pose *)>(
+                [&count](const Entity &, World *, Pose *_pose)
+                {
+                  _pose->position.x++;
+                  count++;
+                  return true;
+                }));
+        });
+    valid = valid && count == numEntities;
+    if (i >= 0)
+      eachTagSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each<World, Pose>(...) (tag)", eachTagSamples));
+
+  std::vector<double> eachFlagSamples;
+  for (auto i = -options.warmup; i < options.reps; ++i)
+  {
+    int count = 0;
+    const auto ms = TimeMs([&ecm, &count]()
+        {
+          ecm.Each<Static, Pose>(
+              std::function<bool(const Entity &, Static *, Pose *)>(
+                [&count](const Entity &, Static *, Pose *_pose)
+                {
+                  _pose->position.x++;
+                  count++;
+                  return true;
+                }));
+        });
+    valid = valid && count == numEntities;
+    if (i >= 0)
+      eachFlagSamples.push_back(ms);
+  }
+  BenchmarkReport::Print(std::cout,
+      report.Add(runner, "Each<Static, Pose>(...) (data)", eachFlagSamples));
+
+  const auto tagBytes = StorageBytes(ecm, World::typeId);
+  const auto flagBytes = StorageBytes(ecm, Static::typeId);
+  report.SetParameter("worldStorageBytes", std::to_string(tagBytes));
+  report.SetParameter("staticStorageBytes", std::to_string(flagBytes));
+  std::cout << std::endl << "World storage (tag):   " << tagBytes
+    << " bytes (" << static_cast<double>(tagBytes) / numEntities
+    << " bytes per entity)" << std::endl << "Static storage (data): "
+    << flagBytes << " bytes (" << static_cast<double>(flagBytes) / numEntities
+    << " bytes per entity)" << std::endl;
+
+  options.WriteResults(report);
+
+  if (!valid)
+  {
+    std::cerr << std::endl << "An Each call visited the wrong number of "
+      << "entities" << std::endl;
+  }
+  return valid ? 0 : 1;
+}
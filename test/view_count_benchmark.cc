@@ -0,0 +1,231 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/BenchmarkOptions.hh"
+#include "benchmark/BenchmarkReport.hh"
+#include "benchmark/BenchmarkStats.hh"
+#include "memory/MemoryRunner.hh"
+#include "memory/MemoryRunnerFactory.hh"
+#include "memory/ProcessMemory.hh"
+#include "memory/ViewPermutations.hh"
+
+/// \brief Print how the benchmark should be run
+/// \param[in] _program The name of the benchmark executable
+void PrintUsage(const std::string &_program)
+{
+  std::cerr << "Usage: " << _program << " <# of entities to create> "
+    << "[# of entities to add/remove components] [options]" << std::endl
+    << std::endl
+    << "Registers views for distinct combinations and orderings of "
+    << "components, and then" << std::endl << "measures entity creation, "
+    << "removing and adding a component, and memory use." << std::endl
+    << "The number of entities to add/remove components defaults to 10% of "
+    << "the entities." << std::endl << std::endl
+    << "Options:" << std::endl << BenchmarkOptions::Usage()
+    << "  --views <n,...>  the view counts to measure, at most "
+    << kMaxViewPermutations << " (default\n"
+    << "                   0,1,10,50,100,150)\n";
+}
+
+/// \brief Time a callable
+/// \param[in] _f The callable
+/// \return The elapsed time, in milliseconds
+double TimeMs(const std::function<void()> &_f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  _f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// \brief The results for one runner and view count
+struct ViewCountResult
+{
+  /// \brief The number of views
+  std::size_t views{0};
+
+  /// \brief The median time to create the entities
+  double createMs{0.0};
+
+  /// \brief The median time to remove a component
+  double removeMs{0.0};
+
+  /// \brief The median time to add a component
+  double addMs{0.0};
+
+  /// \brief The growth of the RSS, in bytes
+  double rssBytes{0.0};
+
+  /// \brief The memory used by views, as reported by the ECM (0 if it can't
+  /// be reported)
+  std::size_t viewBytes{0};
+};
+
+int main(int argc, char **argv)
+{
+  // command line arguments are as follows:
+  //  * the number of entities to create (required)
+  //  * the number of entities to add/remove components (optional)
+  //  * options (see PrintUsage), which may appear anywhere. --runner takes
+  //    the types in MemoryRunnerFactory::Types(), and --instances is ignored,
+  //    since every view count gets a new ECM
+  BenchmarkOptions options;
+  if (!options.Parse(argc, argv, {"--views"}) ||
+      options.positional.empty() || options.positional.size() > 2)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  const auto numEntities = std::stoi(options.positional[0]);
+  const auto numModify = options.positional.size() == 2 ?
+    std::stoi(options.positional[1]) : numEntities / 10;
+  if (numModify > numEntities)
+  {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+  std::vector<std::size_t> viewCounts;
+  std::stringstream viewList(
+      options.Extra("--views", "0,1,10,50,100,150"));
+  std::string item;
+  while (std::getline(viewList, item, ','))
+  {
+    viewCounts.push_back(std::stoul(item));
+    if (viewCounts.back() > kMaxViewPermutations)
+    {
+      std::cerr << "At most " << kMaxViewPermutations << " views can be "
+        << "registered" << std::endl;
+      return -1;
+    }
+  }
+  options.Apply();
+
+  auto implementationTypes = MemoryRunnerFactory::Types();
+  if (!options.runners.empty())
+    implementationTypes = options.runners;
+
+  BenchmarkReport report;
+  report.SetParameter("entities", std::to_string(numEntities));
+  report.SetParameter("entitiesAddRemoveComponent", std::to_string(numModify));
+  options.AddParameters(report);
+
+  std::cout << "Creating ECMs with " << numEntities << " entities and "
+    << "registered views, and removing/adding" << std::endl << "a component "
+    << "on " << numModify << " entities" << std::endl << options.warmup
+    << " warmup call(s), " << options.reps << " repetition(s)" << std::endl;
+
+  for (const auto &ecmType : implementationTypes)
+  {
+    std::cout << std::endl << "-----" << std::endl << std::endl << ecmType
+      << " implementation" << std::endl;
+
+    std::vector<ViewCountResult> results;
+    for (const auto numViews : viewCounts)
+    {
+      ReleaseFreedMemory();
+      const auto baseRss = CurrentRssBytes();
+      MemoryRunner *memoryRunner = MemoryRunnerFactory::Create(ecmType);
+      if (!memoryRunner)
+        break;
+
+      // views are registered before the entities are created, so that
+      // creating the entities has to keep every view up to date
+      bool registered = true;
+      const auto registerMs = TimeMs([memoryRunner, numViews, &registered]()
+          {
+            registered = memoryRunner->RegisterViews(numViews);
+          });
+      if (numViews > 0 && !registered)
+      {
+        std::cout << std::endl << "This implementation doesn't keep views"
+          << std::endl;
+        delete memoryRunner;
+        break;
+      }
+
+      const auto views = " (" + std::to_string(numViews) + " views)";
+      std::cout << std::endl;
+      BenchmarkReport::Print(std::cout, report.Add(ecmType,
+            "Register views" + views, {registerMs}));
+      const auto &create = report.Add(ecmType, "Create entities" + views,
+          {TimeMs([memoryRunner, numEntities]()
+              {
+                for (auto i = 0; i < numEntities; ++i)
+                  memoryRunner->MakeEntityWithComponents();
+              })});
+      BenchmarkReport::Print(std::cout, create);
+
+      ViewCountResult result;
+      result.views = numViews;
+      result.createMs = create.stats.median;
+      result.rssBytes = static_cast<double>(CurrentRssBytes()) -
+        static_cast<double>(baseRss);
+      result.viewBytes = memoryRunner->ViewBytes();
+
+      std::vector<double> removeSamples;
+      std::vector<double> addSamples;
+      for (auto i = -options.warmup; i < options.reps; ++i)
+      {
+        const auto removeMs = TimeMs([memoryRunner, numModify]()
+            {
+              memoryRunner->RemoveAComponent(numModify);
+            });
+        const auto addMs = TimeMs([memoryRunner, numModify]()
+            {
+              memoryRunner->AddAComponent(numModify);
+            });
+        if (i < 0)
+          continue;
+        removeSamples.push_back(removeMs);
+        addSamples.push_back(addMs);
+      }
+      const auto &remove = report.Add(ecmType,
+          "Remove a component" + views, removeSamples);
+      BenchmarkReport::Print(std::cout, remove);
+      result.removeMs = remove.stats.median;
+      const auto &add = report.Add(ecmType,
+          "Add a component" + views, addSamples);
+      BenchmarkReport::Print(std::cout, add);
+      result.addMs = add.stats.median;
+      results.push_back(result);
+
+      delete memoryRunner;
+    }
+    if (results.empty())
+      continue;
+
+    // memory per view is relative to the smallest view count that was
+    // measured, so that the memory used by the entities cancels out
+    const auto &base = results.front();
+    std::cout << std::endl << std::setw(6) << "views" << std::setw(14)
+      << "create ms" << std::setw(14) << "remove ms" << std::setw(14)
+      << "add ms" << std::setw(18) << "RSS/view bytes" << std::setw(18)
+      << "ECM/view bytes" << std::endl;
+    for (const auto &result : results)
+    {
+      const auto extraViews =
+        static_cast<double>(result.views) - static_cast<double>(base.views);
+      std::cout << std::setw(6) << result.views << std::setw(14)
+        << result.createMs << std::setw(14) << result.removeMs
+        << std::setw(14) << result.addMs;
+      if (extraViews > 0)
+      {
+        std::cout << std::setw(18)
+          << (result.rssBytes - base.rssBytes) / extraViews << std::setw(18)
+          << (static_cast<double>(result.viewBytes) -
+              static_cast<double>(base.viewBytes)) / extraViews;
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  options.WriteResults(report);
+
+  return 0;
+}